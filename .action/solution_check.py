@@ -84,6 +84,43 @@ def _run_p1_error(binary, values):
     return status    
 
 
+def _run_digest(binary, values):
+    """Compare the --digest output with a golden digest file"""
+    logger = setup_logger()
+    status = False
+    golden = values[-1]
+    if not os.path.exists(golden):
+        logger.error(f'❌ Missing golden digests {golden}.')
+        return status
+    with open(golden, encoding='utf-8') as golden_file:
+        expected_output = golden_file.read()
+    try:
+        proc = subprocess.run(
+            [binary] + values[:-1],
+            capture_output=True,
+            timeout=60,
+            check=False,
+            text=True,
+        )
+    except subprocess.TimeoutExpired as exception:
+        logger.error('Program did not finish in time.')
+        logger.debug("%s", str(exception))
+        return status
+    if proc.returncode != 0:
+        logger.error("Expected: zero exit code.")
+        logger.error(f'Exit code was {proc.returncode}.')
+        logger.error('Your output: "%s"', proc.stdout + proc.stderr)
+        return status
+    if proc.stdout != expected_output:
+        logger.error(f'❌ Rendered frames do not match {golden}.')
+        logger.error('Expected: "%s"', expected_output)
+        logger.error('Your output: "%s"', proc.stdout)
+        return status
+    logger.info(f'✅ Rendered frames match {golden}.')
+    status = True
+    return status
+
+
 def run_p1(binary):
     """Run part-1"""
     logger = setup_logger()
@@ -95,6 +132,9 @@ def run_p1(binary):
     values = (
                 ['test_output.gif', 'sample_images/sample_image.gif'],
             )
+    digest_values = (
+                ['test_output.gif', '--digest', 'sample_images/sample_image.digest'],
+            )
     for index, val in enumerate(error_values):
         test_number = index + 1
         logger.info('Test %d - %s', test_number, val)
@@ -110,6 +150,14 @@ def run_p1(binary):
         if not rv:
             logger.error("Did not receive expected response for test %d.", test_number)
         status.append(rv)
+
+    for index, val in enumerate(digest_values):
+        test_number = len(error_values) + len(values) + index + 1
+        logger.info('Test %d - %s', test_number, val)
+        rv = _run_digest(binary, val)
+        if not rv:
+            logger.error("Did not receive expected response for test %d.", test_number)
+        status.append(rv)
     return status
 
 
@@ -205,6 +253,10 @@ def run_p2(binary):
     values = (
                 ['test_output.gif', 'CPSC 120A', 'sample_images/sample_image.gif'],
             )
+    digest_values = (
+                ['test_output.gif', '', '--digest', 'sample_images/blank_message.digest'],
+                ['test_output.gif', '', '--digest', '--noise=indexed', 'sample_images/blank_message_indexed.digest'],
+            )
     for index, val in enumerate(error_values):
         test_number = index + 1
         logger.info('Test %d - %s', test_number, val)
@@ -220,6 +272,14 @@ def run_p2(binary):
         if not rv:
             logger.error("Did not receive expected response for test %d.", test_number)
         status.append(rv)
+
+    for index, val in enumerate(digest_values):
+        test_number = len(error_values) + len(values) + index + 1
+        logger.info('Test %d - %s', test_number, val)
+        rv = _run_digest(binary, val)
+        if not rv:
+            logger.error("Did not receive expected response for test %d.", test_number)
+        status.append(rv)
     return status
 
 def _run_p2(binary, values):
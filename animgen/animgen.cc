@@ -0,0 +1,89 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// The libanimgen interface: both animations rendered to memory.
+//
+
+#include "animgen.h"
+
+#include <Magick++.h>
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "frame_pool.h"
+#include "frame_sink.h"
+
+namespace {
+
+std::once_flag magick_initialized;
+
+void CheckSize(int width, int height, int frame_count) {
+  if (width < 1 || height < 1 || frame_count < 1) {
+    throw std::invalid_argument(
+        "An animation needs a positive width, height and number of frames.");
+  }
+}
+
+void CheckFrames(int frame_count, int first_frame, int end_frame) {
+  if (end_frame < 0) {
+    end_frame = frame_count;
+  }
+  if (first_frame < 0 || first_frame >= end_frame || end_frame > frame_count) {
+    throw std::invalid_argument("The frames to render are out of range.");
+  }
+}
+
+// Copy everything written to output into a byte buffer.
+std::vector<unsigned char> StreamBytes(const std::ostringstream& output) {
+  std::string bytes = output.str();
+  return std::vector<unsigned char>(bytes.begin(), bytes.end());
+}
+
+}  // namespace
+
+void InitializeAnimgen(const char* program_path) {
+  std::call_once(magick_initialized,
+                 [program_path] { Magick::InitializeMagick(program_path); });
+}
+
+std::vector<unsigned char> GradientGif(const GradientParams& params,
+                                       int thread_count) {
+  CheckSize(params.image_width, params.image_height, params.number_of_images);
+  CheckFrames(params.number_of_images, params.first_frame, params.end_frame);
+  InitializeAnimgen(nullptr);
+  FramePool frame_pool(params.image_width, params.image_height);
+  std::ostringstream output;
+  GifPipelineSink sink(output, params.image_width, params.image_height,
+                       &frame_pool);
+  RenderGradient(params, std::max(1, thread_count), false, &frame_pool,
+                 &sink);
+  return StreamBytes(output);
+}
+
+std::vector<unsigned char> MessageGif(const MessageParams& params,
+                                      int thread_count) {
+  CheckSize(params.image_width, params.image_height, params.number_of_images);
+  CheckFrames(params.number_of_images, params.first_frame, params.end_frame);
+  if (params.tile_randomness < kMinTileRandomness ||
+      params.tile_randomness > kMaxTileRandomness) {
+    throw std::invalid_argument("The tile randomness is out of range.");
+  }
+  InitializeAnimgen(nullptr);
+  FramePool frame_pool(params.image_width, params.image_height,
+                       MessagePixelFormat(params));
+  std::ostringstream output;
+  GifPipelineSink sink(output, params.image_width, params.image_height,
+                       &frame_pool);
+  RenderMessage(params, std::max(1, thread_count), false, &frame_pool, &sink);
+  return StreamBytes(output);
+}
@@ -0,0 +1,51 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// The libanimgen interface: both animations rendered to memory.
+//
+
+#ifndef ANIMGEN_H
+#define ANIMGEN_H
+
+#include <vector>
+
+#include "animated_gradient_functions.h"
+#include "make_message_functions.h"
+
+// libanimgen renders the animations of animated_gradient and make_message
+// inside the calling process and returns the encoded GIF, so a service can
+// make them without starting a program or going through a temporary file.
+//
+// Every function here may be called from any number of threads at once.
+// GraphicsMagick is initialized the first time it is needed. Each call keeps
+// its own random streams, so the noise of a message animation is the same as
+// the program's and does not depend on what other threads are doing; the
+// global RandomDouble01(), RandomDouble11() and CoinFlip() streams are never
+// used.
+//
+// Invalid sizes throw std::invalid_argument; a failure while encoding
+// throws std::runtime_error or a Magick::Exception.
+
+/// Initialize GraphicsMagick for libanimgen, passing \p program_path (may
+/// be nullptr) on to InitializeMagick(). Only the first call has any effect.
+/// Calling it is optional; the render functions call it themselves.
+void InitializeAnimgen(const char* program_path);
+
+/// Render the animated gradient described by \p params as an animated GIF,
+/// shading each frame with up to \p thread_count threads.
+std::vector<unsigned char> GradientGif(const GradientParams& params,
+                                       int thread_count = 1);
+
+/// Render the message animation described by \p params as an animated GIF.
+/// GIFs of consecutive slices of frames, picked with params.first_frame and
+/// params.end_frame, can be joined by MergeGifs() into the GIF of the whole.
+std::vector<unsigned char> MessageGif(const MessageParams& params,
+                                      int thread_count = 1);
+
+#endif
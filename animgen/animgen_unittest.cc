@@ -0,0 +1,691 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Unit tests for the sources shared by the animation programs.
+//
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "animgen.h"
+#include "batch_manifest.h"
+#include "bounded_queue.h"
+#include "command_line.h"
+#include "frame_buffer.h"
+#include "frame_digest.h"
+#include "frame_pool.h"
+#include "frame_pyramid.h"
+#include "frame_sink.h"
+#include "frame_stream.h"
+#include "gif_stream.h"
+#include "perf_counters.h"
+#include "quality_planner.h"
+#include "waveform_table.h"
+#include "work_stealing_pool.h"
+
+namespace {
+
+// A 2 by 2 GIF with a two color global table and one frame.
+const std::vector<unsigned char> kTinyGif{
+    'G', 'I', 'F', '8', '9', 'a', 2, 0, 2, 0, 0x80, 0, 0,
+    // Global color table: black and white.
+    0, 0, 0, 255, 255, 255,
+    // Graphic control extension with a delay of 10.
+    0x21, 0xF9, 4, 0, 10, 0, 0, 0,
+    // Image descriptor and LZW data.
+    0x2C, 0, 0, 0, 0, 2, 0, 2, 0, 0, 2, 3, 0x44, 0x02, 0x05, 0,
+    // Trailer.
+    0x3B};
+
+TEST(CommandLine, SplitsOptionsFromArguments) {
+  CommandLine command_line = ParseCommandLine(
+      {"program", "out.gif", "--format=y4m", "CPSC 120A", "--digest"});
+  ASSERT_EQ(3, command_line.arguments.size());
+  EXPECT_EQ("out.gif", command_line.arguments.at(1));
+  EXPECT_EQ("CPSC 120A", command_line.arguments.at(2));
+  EXPECT_EQ("y4m", OptionValue(command_line, "format", "gif"));
+  EXPECT_TRUE(HasOption(command_line, "digest"));
+  EXPECT_EQ("gif", OptionValue(command_line, "sizes", "gif"));
+}
+
+TEST(CommandLine, IntegerOptionValue) {
+  CommandLine command_line =
+      ParseCommandLine({"program", "--threads=4", "--frames=x"});
+  int value{0};
+  EXPECT_TRUE(IntegerOptionValue(command_line, "threads", 1, &value));
+  EXPECT_EQ(4, value);
+  EXPECT_TRUE(IntegerOptionValue(command_line, "missing", 7, &value));
+  EXPECT_EQ(7, value);
+  EXPECT_FALSE(IntegerOptionValue(command_line, "frames", 1, &value));
+}
+
+TEST(CommandLine, FrameRangeOptionValue) {
+  int first_frame{0};
+  int end_frame{0};
+  CommandLine all_frames = ParseCommandLine({"program"});
+  EXPECT_TRUE(FrameRangeOptionValue(all_frames, "frames", 10, &first_frame,
+                                    &end_frame));
+  EXPECT_EQ(0, first_frame);
+  EXPECT_EQ(-1, end_frame);
+  CommandLine slice = ParseCommandLine({"program", "--frames=5-9"});
+  EXPECT_TRUE(
+      FrameRangeOptionValue(slice, "frames", 10, &first_frame, &end_frame));
+  EXPECT_EQ(5, first_frame);
+  EXPECT_EQ(10, end_frame);
+  for (const char* bad_range :
+       {"--frames=5-10", "--frames=6-5", "--frames=-1-3", "--frames=4",
+        "--frames=1-x", "--frames="}) {
+    CommandLine command_line = ParseCommandLine({"program", bad_range});
+    EXPECT_FALSE(FrameRangeOptionValue(command_line, "frames", 10,
+                                       &first_frame, &end_frame))
+        << bad_range;
+  }
+}
+
+TEST(RawFrameWriter, Y4mHeaderAndPlanes) {
+  std::ostringstream output;
+  RawFrameWriter writer(output, OutputFormat::kY4m, 2, 1, 10);
+  const unsigned char rgb[] = {0, 0, 0, 255, 255, 255};
+  writer.WriteFrame(rgb);
+  std::string expected_header = "YUV4MPEG2 W2 H1 F10:1 Ip A1:1 C444\nFRAME\n";
+  std::string bytes = output.str();
+  ASSERT_EQ(expected_header.size() + 6, bytes.size());
+  EXPECT_EQ(expected_header, bytes.substr(0, expected_header.size()));
+  // Black and white in studio range Y, Cb and Cr.
+  std::string planes = bytes.substr(expected_header.size());
+  EXPECT_EQ(16, (unsigned char)planes[0]);
+  EXPECT_EQ(235, (unsigned char)planes[1]);
+  EXPECT_EQ(128, (unsigned char)planes[2]);
+  EXPECT_EQ(128, (unsigned char)planes[4]);
+}
+
+TEST(ParseGif, FindsFrames) {
+  GifFile gif;
+  ASSERT_TRUE(ParseGif(kTinyGif, &gif));
+  EXPECT_EQ(2, gif.width);
+  EXPECT_EQ(2, gif.height);
+  ASSERT_EQ(1, gif.frames.size());
+  const GifFrame& frame = gif.frames.front();
+  EXPECT_EQ(6, frame.color_table.size());
+  EXPECT_EQ(std::vector<unsigned char>({0, 10, 0, 0}), frame.graphic_control);
+  EXPECT_EQ(std::vector<unsigned char>({2, 3, 0x44, 0x02, 0x05, 0}),
+            frame.image_data);
+}
+
+TEST(ParseGif, RejectsTruncatedFiles) {
+  GifFile gif;
+  std::vector<unsigned char> truncated(kTinyGif.begin(), kTinyGif.begin() + 30);
+  EXPECT_FALSE(ParseGif(truncated, &gif));
+  EXPECT_FALSE(ParseGif({'P', 'N', 'G'}, &gif));
+}
+
+TEST(GifStreamWriter, RoundTrip) {
+  GifFile gif;
+  ASSERT_TRUE(ParseGif(kTinyGif, &gif));
+  std::ostringstream output;
+  GifStreamWriter writer(output, 2, 2);
+  writer.WriteFrame(gif.frames.front());
+  writer.WriteFrame(gif.frames.front());
+  writer.Finish();
+  std::string bytes = output.str();
+  GifFile animation;
+  ASSERT_TRUE(ParseGif({bytes.begin(), bytes.end()}, &animation));
+  ASSERT_EQ(2, animation.frames.size());
+  for (const GifFrame& frame : animation.frames) {
+    EXPECT_EQ(gif.frames.front().color_table, frame.color_table);
+    EXPECT_EQ(gif.frames.front().image_data, frame.image_data);
+    EXPECT_EQ(gif.frames.front().graphic_control, frame.graphic_control);
+  }
+}
+
+TEST(EncodeIndexedFrame, MatchesReferenceEncoding) {
+  // The 3 by 5 example image from the GIF article on Wikipedia, whose LZW
+  // data is worked through code by code there.
+  std::vector<unsigned char> indices{0x28, 0xFF, 0xFF, 0xFF, 0x28,
+                                     0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                     0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+  std::vector<unsigned char> color_table(256 * 3);
+  GifFrame frame = EncodeIndexedFrame(indices.data(), 3, 5, color_table);
+  std::vector<unsigned char> expected{8,    0x0B, 0x00, 0x51, 0xFC,
+                                      0x1B, 0x28, 0x70, 0xA0, 0xC1,
+                                      0x83, 0x01, 0x01, 0};
+  EXPECT_EQ(expected, frame.image_data);
+}
+
+TEST(EncodeIndexedFrame, RoundTrip) {
+  std::mt19937 engine{120};
+  for (int colors : {2, 5, 256}) {
+    // Enough pixels to fill the code table several times over.
+    std::vector<unsigned char> indices(300 * 97);
+    for (unsigned char& index : indices) {
+      index = engine() % 4 ? 0 : engine() % colors;
+    }
+    std::vector<unsigned char> color_table(colors * 3);
+    GifFrame frame =
+        EncodeIndexedFrame(indices.data(), 300, 97, color_table);
+    std::vector<unsigned char> decoded;
+    ASSERT_TRUE(DecodeIndexedFrame(frame, &decoded));
+    EXPECT_EQ(indices, decoded);
+  }
+  GifFile gif;
+  ASSERT_TRUE(ParseGif(kTinyGif, &gif));
+  std::vector<unsigned char> decoded;
+  ASSERT_TRUE(DecodeIndexedFrame(gif.frames.front(), &decoded));
+  EXPECT_EQ(std::vector<unsigned char>({0, 1, 1, 0}), decoded);
+}
+
+TEST(BoundedQueue, KeepsOrderAcrossThreads) {
+  BoundedQueue<int> queue(2);
+  std::thread producer([&queue] {
+    for (int i = 0; i < 100; i++) {
+      queue.Push(int(i));
+    }
+    queue.Close();
+  });
+  std::vector<int> received;
+  int item{0};
+  while (queue.Pop(&item)) {
+    received.push_back(item);
+  }
+  producer.join();
+  ASSERT_EQ(100, received.size());
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(i, received.at(i));
+  }
+}
+
+TEST(WorkStealingPool, RunsNestedTasks) {
+  std::atomic<int> finished{0};
+  {
+    WorkStealingPool pool(4);
+    for (int task = 0; task < 50; task++) {
+      pool.Submit([&pool, &finished] {
+        pool.Submit([&finished] { finished++; });
+        finished++;
+      });
+    }
+    pool.Wait();
+    EXPECT_EQ(100, finished);
+  }
+  EXPECT_EQ(100, finished);
+}
+
+TEST(FrameBuffer, AlignsAndSizesPixels) {
+  FrameBuffer small(5, 3, PixelFormat::kRgb8);
+  EXPECT_EQ(15, small.row_bytes());
+  EXPECT_EQ(45, small.size_bytes());
+  EXPECT_EQ(small.data() + 30, small.row(2));
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(small.data()) % 64);
+  // A 4K RGB8 frame is big enough to be placed on huge page boundaries.
+  FrameBuffer large(3840, 2160, PixelFormat::kRgb8);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(large.data()) % (2 << 20));
+  FrameBuffer indexed(3840, 2160, PixelFormat::kIndexed8);
+  EXPECT_EQ(3840 * 2160, indexed.size_bytes());
+}
+
+TEST(DigestBytes, MatchesFnv1a) {
+  const unsigned char kLetterA[] = {'a'};
+  EXPECT_EQ("cbf29ce484222325", DigestText(DigestBytes(nullptr, 0)));
+  EXPECT_EQ("af63dc4c8601ec8c", DigestText(DigestBytes(kLetterA, 1)));
+}
+
+TEST(DigestSink, DigestsIndexedFramesByColor) {
+  FramePool rgb_pool(2, 1);
+  FramePool indexed_pool(2, 1, PixelFormat::kIndexed8);
+  FrameBuffer rgb = rgb_pool.Acquire();
+  const unsigned char kPixels[] = {10, 20, 30, 40, 50, 60};
+  std::copy(kPixels, kPixels + 6, rgb.data());
+  FrameBuffer indexed = indexed_pool.Acquire();
+  indexed.data()[0] = 1;
+  indexed.data()[1] = 0;
+  std::ostringstream rgb_digests;
+  DigestSink rgb_sink(rgb_digests, 4, &rgb_pool);
+  rgb_sink.Consume(std::move(rgb));
+  rgb_sink.Finish();
+  std::ostringstream indexed_digests;
+  DigestSink indexed_sink(indexed_digests, 4, &indexed_pool);
+  indexed_sink.ConsumeIndexed(std::move(indexed),
+                              {40, 50, 60, 10, 20, 30});
+  indexed_sink.Finish();
+  EXPECT_EQ(rgb_digests.str(), indexed_digests.str());
+  EXPECT_EQ(0, rgb_digests.str().find(
+                   "frame 4 " + DigestText(DigestBytes(kPixels, 6)) +
+                   "\nanimation "));
+}
+
+TEST(FramePool, ReusesReleasedFrames) {
+  FramePool pool(4, 4, PixelFormat::kIndexed8);
+  FrameBuffer frame = pool.Acquire();
+  EXPECT_EQ(PixelFormat::kIndexed8, frame.format());
+  const unsigned char* pixels = frame.data();
+  pool.Release(std::move(frame));
+  EXPECT_EQ(pixels, pool.Acquire().data());
+  // Frames of another size are not kept.
+  pool.Release(FrameBuffer(2, 2, PixelFormat::kIndexed8));
+  EXPECT_EQ(16, pool.Acquire().size_bytes());
+  // Nor are frames whose pixels were moved to another frame.
+  FrameBuffer moved_from = pool.Acquire();
+  FrameBuffer moved_to{std::move(moved_from)};
+  pool.Release(std::move(moved_from));
+  EXPECT_NE(nullptr, pool.Acquire().data());
+}
+
+// Keeps every frame it is given.
+class RecordingSink : public FrameSink {
+ public:
+  void Consume(FrameBuffer&& frame) override {
+    frames.push_back(std::move(frame));
+  }
+  void ConsumeIndexed(FrameBuffer&& frame,
+                      const std::vector<unsigned char>& color_table) override {
+    frames.push_back(std::move(frame));
+  }
+  void Finish() override { finished = true; }
+
+  std::vector<FrameBuffer> frames;
+  bool finished = false;
+};
+
+TEST(DownsampleHalf, AveragesBlocks) {
+  // A 5 by 2 frame; the odd last column is dropped.
+  FrameBuffer source(5, 2, PixelFormat::kRgb8);
+  for (std::size_t byte = 0; byte < source.size_bytes(); byte++) {
+    source.data()[byte] = (unsigned char)(byte * 8);
+  }
+  FrameBuffer half(2, 1, PixelFormat::kRgb8);
+  DownsampleHalf(source, &half);
+  // Pixel 0 averages bytes 0, 3, 15 and 18 of each channel.
+  EXPECT_EQ(72, half.data()[0]);
+  EXPECT_EQ(80, half.data()[1]);
+  EXPECT_EQ(120, half.data()[3]);
+  FrameBuffer indices(4, 2, PixelFormat::kIndexed8);
+  for (int pixel = 0; pixel < 8; pixel++) {
+    indices.data()[pixel] = (unsigned char)pixel;
+  }
+  FrameBuffer half_indices(2, 1, PixelFormat::kIndexed8);
+  DecimateHalf(indices, &half_indices);
+  EXPECT_EQ(0, half_indices.data()[0]);
+  EXPECT_EQ(2, half_indices.data()[1]);
+}
+
+TEST(PyramidSink, ShrinksEveryFrame) {
+  EXPECT_EQ(4, MaxPyramidLevels(8, 9));
+  EXPECT_EQ("out-4x2.gif", PyramidLevelFileName("out.gif", 4, 2));
+  EXPECT_EQ("a.b/out-4x2", PyramidLevelFileName("a.b/out", 4, 2));
+  FramePool pool(8, 4);
+  std::vector<PyramidSink::Level> levels;
+  std::vector<RecordingSink*> sinks;
+  for (int level = 0; level < 3; level++) {
+    PyramidSink::Level pyramid_level;
+    if (level > 0) {
+      pyramid_level.pool =
+          std::make_unique<FramePool>(8 >> level, 4 >> level);
+    }
+    auto sink = std::make_unique<RecordingSink>();
+    sinks.push_back(sink.get());
+    pyramid_level.sink = std::move(sink);
+    levels.push_back(std::move(pyramid_level));
+  }
+  PyramidSink pyramid(std::move(levels));
+  FrameBuffer frame = pool.Acquire();
+  std::fill(frame.data(), frame.data() + frame.size_bytes(), 200);
+  pyramid.Consume(std::move(frame));
+  pyramid.Finish();
+  for (int level = 0; level < 3; level++) {
+    ASSERT_EQ(1, sinks.at(level)->frames.size());
+    const FrameBuffer& shrunk = sinks.at(level)->frames.front();
+    EXPECT_EQ(8 >> level, shrunk.width());
+    EXPECT_EQ(4 >> level, shrunk.height());
+    EXPECT_EQ(200, shrunk.data()[shrunk.size_bytes() - 1]);
+    EXPECT_TRUE(sinks.at(level)->finished);
+  }
+}
+
+TEST(WaveformTable, WrapsWithoutModulo) {
+  WaveformTable sine(Waveform::kSine, 8, 32.0);
+  for (int index = 0; index < 16; index++) {
+    EXPECT_EQ(sin(M_PI / 16.0 * (index % 8)), sine[index]);
+  }
+  WaveformTable triangle(Waveform::kTriangle, 4, 4.0);
+  EXPECT_DOUBLE_EQ(0.0, triangle[0]);
+  EXPECT_DOUBLE_EQ(1.0, triangle[1]);
+  EXPECT_DOUBLE_EQ(0.0, triangle[2]);
+  EXPECT_DOUBLE_EQ(-1.0, triangle[3]);
+  EXPECT_DOUBLE_EQ(0.0, triangle[4]);
+  WaveformTable smooth(Waveform::kSmoothstep, 8, 8.0);
+  EXPECT_DOUBLE_EQ(1.0, smooth[2]);
+  EXPECT_DOUBLE_EQ(0.0, smooth[4]);
+  // Halfway up the triangle eases to 2 * smoothstep(0.75) - 1.
+  EXPECT_DOUBLE_EQ(0.6875, smooth[1]);
+  WaveformTable cosine(Waveform::kCosine, 4, 4.0);
+  EXPECT_NEAR(0.0, cosine[1], 1e-12);
+  EXPECT_DOUBLE_EQ(-1.0, cosine[2]);
+}
+
+TEST(WaveformTable, RejectsEmptyTables) {
+  EXPECT_THROW(WaveformTable(Waveform::kSine, 0, 2.0), std::invalid_argument);
+  EXPECT_THROW(SharedWaveformTable(Waveform::kSine, -4, 2.0),
+               std::invalid_argument);
+}
+
+TEST(WaveformTable, InterpolatesInFixedPoint) {
+  WaveformTable triangle(Waveform::kTriangle, 4, 4.0);
+  unsigned long long half = 1ULL << (WaveformTable::kFractionBits - 1);
+  EXPECT_DOUBLE_EQ(0.5, triangle.Interpolate(half));
+  EXPECT_DOUBLE_EQ(-0.5, triangle.Interpolate(3 * 2 * half + half));
+  // Reading 4 entries as 16 steps a quarter of an entry apart.
+  unsigned long long step = triangle.FixedPointStep(16);
+  EXPECT_EQ(half / 2, step);
+  EXPECT_DOUBLE_EQ(0.75, triangle.Interpolate(3 * step));
+}
+
+TEST(SharedWaveformTable, SharesTablesAcrossThreads) {
+  std::vector<std::shared_ptr<const WaveformTable>> tables(4);
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; thread++) {
+    threads.emplace_back([&tables, thread] {
+      tables.at(thread) = SharedWaveformTable(Waveform::kSine, 100, 200.0);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const auto& table : tables) {
+    EXPECT_EQ(tables.front(), table);
+  }
+  EXPECT_NE(tables.front(), SharedWaveformTable(Waveform::kSine, 100, 100.0));
+}
+
+TEST(SharedWaveformTable, FreesTablesNobodyHolds) {
+  std::shared_ptr<const WaveformTable> held =
+      SharedWaveformTable(Waveform::kTriangle, 37, 74.0);
+  std::weak_ptr<const WaveformTable> watched = held;
+  EXPECT_EQ(held, SharedWaveformTable(Waveform::kTriangle, 37, 74.0));
+  held.reset();
+  EXPECT_TRUE(watched.expired());
+  std::shared_ptr<const WaveformTable> rebuilt =
+      SharedWaveformTable(Waveform::kTriangle, 37, 74.0);
+  ASSERT_TRUE(rebuilt);
+  EXPECT_EQ(37, rebuilt->length());
+}
+
+TEST(MessageGif, RendersInMemoryFromManyThreads) {
+  MessageParams params{40, 30, 3, ""};
+  // Indexed noise skips GraphicsMagick's quantizer, so the bytes only depend
+  // on this library.
+  params.noise = MessageNoise::kIndexed;
+  std::vector<std::vector<unsigned char>> gifs(4);
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; thread++) {
+    threads.emplace_back(
+        [&gifs, &params, thread] { gifs.at(thread) = MessageGif(params); });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (const std::vector<unsigned char>& gif : gifs) {
+    EXPECT_EQ(gifs.front(), gif);
+  }
+  GifFile animation;
+  ASSERT_TRUE(ParseGif(gifs.front(), &animation));
+  ASSERT_EQ(3, animation.frames.size());
+  std::vector<unsigned char> expected(40 * 30);
+  IndexedNoise(40, 30).Render(2, expected.data());
+  std::vector<unsigned char> decoded;
+  ASSERT_TRUE(DecodeIndexedFrame(animation.frames.at(2), &decoded));
+  EXPECT_EQ(expected, decoded);
+}
+
+TEST(MessageGif, MergedSlicesMatchOneRun) {
+  MessageParams params{40, 30, 5, ""};
+  params.noise = MessageNoise::kIndexed;
+  std::vector<unsigned char> whole = MessageGif(params);
+  std::vector<GifFile> slices(2);
+  params.end_frame = 2;
+  ASSERT_TRUE(ParseGif(MessageGif(params), &slices.at(0)));
+  params.first_frame = 2;
+  params.end_frame = 5;
+  ASSERT_TRUE(ParseGif(MessageGif(params), &slices.at(1)));
+  EXPECT_EQ(2, slices.at(0).frames.size());
+  EXPECT_EQ(3, slices.at(1).frames.size());
+  std::ostringstream merged;
+  std::string error_message;
+  ASSERT_TRUE(MergeGifs(slices, merged, &error_message));
+  std::string bytes = merged.str();
+  EXPECT_EQ(whole, std::vector<unsigned char>(bytes.begin(), bytes.end()));
+}
+
+TEST(MergeGifs, RejectsMismatchedSizes) {
+  std::vector<GifFile> parts(2);
+  parts.at(0).width = 4;
+  parts.at(0).height = 4;
+  parts.at(1).width = 4;
+  parts.at(1).height = 2;
+  std::ostringstream merged;
+  std::string error_message;
+  EXPECT_FALSE(MergeGifs(parts, merged, &error_message));
+  EXPECT_FALSE(error_message.empty());
+  EXPECT_FALSE(MergeGifs({}, merged, &error_message));
+}
+
+TEST(GradientGif, QuantizesRgbFrames) {
+  // Enough frames that the pool hands out frames the pipeline gave back.
+  std::vector<unsigned char> gif = GradientGif(GradientParams{64, 48, 10});
+  GifFile animation;
+  ASSERT_TRUE(ParseGif(gif, &animation));
+  EXPECT_EQ(64, animation.width);
+  EXPECT_EQ(48, animation.height);
+  EXPECT_EQ(10, animation.frames.size());
+}
+
+TEST(GradientGif, RendersTallGradients) {
+  std::vector<unsigned char> gif = GradientGif(GradientParams{16, 90, 4});
+  GifFile animation;
+  ASSERT_TRUE(ParseGif(gif, &animation));
+  EXPECT_EQ(16, animation.width);
+  EXPECT_EQ(90, animation.height);
+  EXPECT_EQ(4, animation.frames.size());
+}
+
+TEST(GradientGif, RejectsBadSizes) {
+  EXPECT_THROW(GradientGif(GradientParams{0, 10, 10}), std::invalid_argument);
+  EXPECT_THROW(GradientGif(GradientParams{10, 20, 0}), std::invalid_argument);
+  MessageParams params{10, 10, 1, "Hi"};
+  params.tile_randomness = 0;
+  params.noise = MessageNoise::kTiles;
+  EXPECT_THROW(MessageGif(params), std::invalid_argument);
+  params.tile_randomness = 3;
+  params.first_frame = 1;
+  EXPECT_THROW(MessageGif(params), std::invalid_argument);
+}
+
+TEST(PlanQuality, KeepsFullQualityWhenItFits) {
+  QualityPlan plan = PlanQuality(512, 512, 10, 0.6, 10.0, 1000.0);
+  EXPECT_EQ(512, plan.width);
+  EXPECT_EQ(512, plan.height);
+  EXPECT_EQ(10, plan.frame_count);
+  EXPECT_FALSE(plan.fast_quantization);
+  EXPECT_TRUE(plan.degradations.empty());
+}
+
+TEST(PlanQuality, LowersQuantizationEffortFirst) {
+  QualityPlan plan = PlanQuality(512, 512, 10, 0.6, 10.0, 70.0);
+  EXPECT_TRUE(plan.fast_quantization);
+  EXPECT_EQ(512, plan.width);
+  EXPECT_EQ(10, plan.frame_count);
+  EXPECT_EQ(1, plan.degradations.size());
+}
+
+TEST(PlanQuality, LowersResolutionBeforeFrames) {
+  // Indexed frames are not quantized, so resolution is the first to go.
+  QualityPlan plan = PlanQuality(1024, 576, 10, 1.0, 10.0, 50.0);
+  EXPECT_FALSE(plan.fast_quantization);
+  EXPECT_EQ(10, plan.frame_count);
+  EXPECT_LT(plan.width, 1024);
+  EXPECT_GE(plan.width, 512);
+  EXPECT_NEAR(1024.0 / 576.0, double(plan.width) / plan.height, 0.01);
+  EXPECT_LE(10.0 * 10.0 * plan.width * plan.height / (1024.0 * 576.0), 50.0);
+  ASSERT_EQ(1, plan.degradations.size());
+  EXPECT_NE(std::string::npos, plan.degradations.at(0).find("resolution"));
+}
+
+TEST(PlanQuality, DropsFramesAtHalfResolution) {
+  QualityPlan plan = PlanQuality(512, 512, 10, 1.0, 10.0, 10.0);
+  EXPECT_EQ(256, plan.width);
+  EXPECT_EQ(256, plan.height);
+  EXPECT_EQ(4, plan.frame_count);
+  EXPECT_EQ(2, plan.degradations.size());
+}
+
+TEST(PlanQuality, ReportsADeadlineItCannotMeet) {
+  QualityPlan plan = PlanQuality(512, 512, 10, 0.6, 10.0, 0.01);
+  EXPECT_TRUE(plan.fast_quantization);
+  EXPECT_EQ(128, plan.width);
+  EXPECT_EQ(128, plan.height);
+  EXPECT_EQ(1, plan.frame_count);
+  ASSERT_FALSE(plan.degradations.empty());
+  EXPECT_NE(std::string::npos, plan.degradations.back().find("missed"));
+}
+
+TEST(ProbeSink, GivesFramesBack) {
+  FramePool frame_pool(4, 4, PixelFormat::kIndexed8);
+  ProbeSink probe(true, &frame_pool);
+  FrameBuffer frame = frame_pool.Acquire();
+  std::fill(frame.data(), frame.data() + frame.size_bytes(), 1);
+  const unsigned char* pixels = frame.data();
+  probe.ConsumeIndexed(std::move(frame), {0, 0, 0, 255, 255, 255});
+  probe.Finish();
+  EXPECT_EQ(pixels, frame_pool.Acquire().data());
+  EXPECT_EQ(1.0, probe.fast_quantization_cost());
+}
+
+TEST(ProbeSink, TimesTheLastFrame) {
+  FramePool frame_pool(64, 48);
+  ProbeSink probe(true, &frame_pool);
+  EXPECT_EQ(0.0, probe.frame_ms());
+  for (int frame = 0; frame < 2; frame++) {
+    // Setting up before the first frame is not part of a frame's time.
+    if (frame == 0) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    FrameBuffer image = frame_pool.Acquire();
+    std::fill(image.data(), image.data() + image.size_bytes(), 100);
+    probe.Consume(std::move(image));
+  }
+  EXPECT_GT(probe.frame_ms(), 0.0);
+  EXPECT_LT(probe.frame_ms(), 50.0);
+  EXPECT_GT(probe.fast_quantization_cost(), 0.0);
+  EXPECT_LE(probe.fast_quantization_cost(), 1.0);
+}
+
+TEST(PerfCounters, CountsOrExplainsWhyNot) {
+  PerfCounters counters;
+  if (!counters.available()) {
+    EXPECT_FALSE(counters.error().empty());
+    PerfSample sample = counters.Read();
+    for (long long count : sample.counts) {
+      EXPECT_EQ(-1, count);
+    }
+    return;
+  }
+  volatile unsigned sum{0};
+  for (unsigned i = 0; i < 100000; i++) {
+    sum = sum + i;
+  }
+  PerfSample sample = counters.Read();
+  long long instructions = sample.count(PerfEvent::kInstructions);
+  if (instructions >= 0) {
+    EXPECT_GT(instructions, 100000);
+  }
+}
+
+TEST(FrameProfiler, ReportsEachFrame) {
+  FrameProfiler profiler(100);
+  PerfSample sample;
+  sample.counts = {2000000, 4000000, 50, -1, 10};
+  profiler.Record("setup", sample);
+  profiler.Record("render", sample);
+  profiler.Record("render", sample);
+  std::ostringstream report;
+  report << 1.5;
+  profiler.Report(report);
+  report << 1.5;
+  std::string text = report.str();
+  EXPECT_NE(std::string::npos,
+            text.find("setup: cycles 2.00M, IPC 2.00, per pixel: L1 misses "
+                      "0.500, LLC misses n/a, branch misses 0.100\n"));
+  EXPECT_NE(std::string::npos, text.find("render image 2: cycles 2.00M"));
+  EXPECT_NE(std::string::npos, text.find("render total: cycles 4.00M"));
+  // The stream's number format is left as it was.
+  EXPECT_EQ("1.5", text.substr(0, 3));
+  EXPECT_EQ("1.5", text.substr(text.size() - 3));
+}
+
+TEST(FrameProfiler, ReportsMissingCounters) {
+  FrameProfiler profiler(100);
+  profiler.RecordUnavailable("no counters here");
+  {
+    ProfileScope nothing(nullptr, "render");
+  }
+  std::ostringstream report;
+  profiler.Report(report);
+  EXPECT_EQ(
+      "Hardware performance counters are not available (no counters here); "
+      "nothing was profiled.\n",
+      report.str());
+}
+
+TEST(ReadManifest, ReadsJobs) {
+  std::istringstream manifest(
+      "# A comment\n"
+      "gradient 512 512 10 gradient.gif\n"
+      "\n"
+      "message 1024 576 5 message.gif CPSC 120A\n");
+  std::vector<BatchJob> jobs;
+  std::string error_message;
+  ASSERT_TRUE(ReadManifest(manifest, &jobs, &error_message));
+  ASSERT_EQ(2, jobs.size());
+  EXPECT_EQ(JobType::kGradient, jobs.at(0).type);
+  EXPECT_EQ(512, jobs.at(0).width);
+  EXPECT_EQ(10, jobs.at(0).frame_count);
+  EXPECT_EQ("gradient.gif", jobs.at(0).output_file_name);
+  EXPECT_EQ(JobType::kMessage, jobs.at(1).type);
+  EXPECT_EQ(576, jobs.at(1).height);
+  EXPECT_EQ("CPSC 120A", jobs.at(1).message);
+}
+
+TEST(ReadManifest, RejectsBadJobs) {
+  std::vector<std::string> bad_lines{
+      "spiral 512 512 10 spiral.gif", "gradient 512 0 10 gradient.gif",
+      "gradient 512 512 10 gradient.png", "message 512 512 10 message.gif",
+      "gradient 512 512"};
+  for (const std::string& line : bad_lines) {
+    std::istringstream manifest(line);
+    std::vector<BatchJob> jobs;
+    std::string error_message;
+    EXPECT_FALSE(ReadManifest(manifest, &jobs, &error_message)) << line;
+    EXPECT_FALSE(error_message.empty());
+  }
+}
+
+}  // namespace
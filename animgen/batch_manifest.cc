@@ -0,0 +1,62 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Reads the list of jobs for the batch renderer.
+//
+
+#include "batch_manifest.h"
+
+#include <sstream>
+
+#include "command_line.h"
+
+bool ReadManifest(std::istream& manifest, std::vector<BatchJob>* jobs,
+                  std::string* error_message) {
+  std::string line;
+  int line_number{0};
+  while (std::getline(manifest, line)) {
+    line_number++;
+    std::istringstream fields(line);
+    std::string type;
+    if (!(fields >> type) || type.front() == '#') {
+      continue;
+    }
+    std::string where = "Line " + std::to_string(line_number) + ": ";
+    BatchJob job;
+    if (type == "gradient") {
+      job.type = JobType::kGradient;
+    } else if (type == "message") {
+      job.type = JobType::kMessage;
+    } else {
+      *error_message = where + "unknown job type " + type + ".";
+      return false;
+    }
+    if (!(fields >> job.width >> job.height >> job.frame_count >>
+          job.output_file_name) ||
+        job.width < 1 || job.height < 1 || job.frame_count < 1) {
+      *error_message =
+          where + "expected positive WIDTH HEIGHT FRAMES and an OUTPUT file.";
+      return false;
+    }
+    if (!HasFileExtension(job.output_file_name, ".gif")) {
+      *error_message = where + job.output_file_name +
+                       " is missing the required file extension .gif.";
+      return false;
+    }
+    if (job.type == JobType::kMessage) {
+      std::getline(fields >> std::ws, job.message);
+      if (job.message.empty()) {
+        *error_message = where + "message jobs need a message.";
+        return false;
+      }
+    }
+    jobs->push_back(job);
+  }
+  return true;
+}
@@ -0,0 +1,50 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Reads the list of jobs for the batch renderer.
+//
+
+#ifndef BATCH_MANIFEST_H
+#define BATCH_MANIFEST_H
+
+#include <istream>
+#include <string>
+#include <vector>
+
+/// The animations the batch renderer knows how to make.
+enum class JobType {
+  /// The animated gradient from part-1.
+  kGradient,
+  /// The message on random noise from part-2.
+  kMessage,
+};
+
+/// One animation to render.
+struct BatchJob {
+  JobType type;
+  int width;
+  int height;
+  int frame_count;
+  std::string output_file_name;
+  /// The text drawn by message jobs.
+  std::string message;
+};
+
+/// Read the jobs in \p manifest into \p jobs. Each line holds one job:
+///
+///   gradient WIDTH HEIGHT FRAMES OUTPUT.gif
+///   message WIDTH HEIGHT FRAMES OUTPUT.gif MESSAGE TEXT
+///
+/// where the message is the rest of the line. Blank lines and lines that
+/// start with # are ignored. Returns false and sets \p error_message if a
+/// line is not a valid job.
+bool ReadManifest(std::istream& manifest, std::vector<BatchJob>* jobs,
+                  std::string* error_message);
+
+#endif
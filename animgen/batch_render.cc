@@ -0,0 +1,227 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Renders every animation listed in a manifest in one process.
+//
+
+#include <Magick++.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "animated_gradient_functions.h"
+#include "batch_manifest.h"
+#include "command_line.h"
+#include "frame_buffer.h"
+#include "frame_renderer.h"
+#include "frame_sink.h"
+#include "gif_stream.h"
+#include "make_message_functions.h"
+#include "work_stealing_pool.h"
+
+// The progress of one job. Frames are rendered and encoded by independent
+// tasks; the task that encodes the last frame queues the write.
+struct JobState {
+  BatchJob job;
+  // Made once per job by PrepareJob(). Gradient frames share the lookup
+  // tables; message frames share the drawn text and one noise shader that
+  // draws its random numbers one frame after another.
+  std::unique_ptr<GradientShader> gradient_shader;
+  std::vector<unsigned char> coverage;
+  std::unique_ptr<NoiseShader> noise_shader;
+  std::vector<GifFrame> frames;
+  std::atomic<int> frames_left{0};
+  std::mutex error_mutex;
+  std::string error_message;
+};
+
+// Serializes progress messages from the workers.
+std::mutex report_mutex;
+
+void PrepareJob(JobState* state) {
+  const BatchJob& job = state->job;
+  if (job.type == JobType::kGradient) {
+    state->gradient_shader = std::make_unique<GradientShader>(
+        job.width, job.height, job.frame_count);
+    return;
+  }
+  state->coverage = MessageCoverage(job.message, job.width, job.height);
+  state->noise_shader = std::make_unique<NoiseShader>(job.width, job.height);
+}
+
+// Message frames must be rendered in order, so that the noise shader never
+// has to replay the random numbers of earlier frames.
+FrameBuffer RenderJobFrame(JobState* state, int frame) {
+  FrameBuffer image(state->job.width, state->job.height, PixelFormat::kRgb8);
+  if (state->job.type == JobType::kGradient) {
+    ShadeFrame(*state->gradient_shader, frame, 1, &image);
+  } else {
+    ShadeFrame(*state->noise_shader, frame, 1, &image);
+    BlendMessage(state->coverage, &image);
+  }
+  return image;
+}
+
+void RecordJobError(JobState* state, const std::string& error_message) {
+  std::lock_guard<std::mutex> lock(state->error_mutex);
+  if (state->error_message.empty()) {
+    state->error_message = error_message;
+  }
+}
+
+void WriteJob(JobState* state) {
+  {
+    std::lock_guard<std::mutex> lock(state->error_mutex);
+    if (!state->error_message.empty()) {
+      return;
+    }
+  }
+  std::ofstream output_file(state->job.output_file_name, std::ios::binary);
+  GifStreamWriter gif_writer(output_file, state->job.width, state->job.height);
+  for (const GifFrame& frame : state->frames) {
+    gif_writer.WriteFrame(frame);
+  }
+  gif_writer.Finish();
+  state->frames.clear();
+  if (!output_file) {
+    RecordJobError(state,
+                   "Could not write " + state->job.output_file_name + ".");
+    return;
+  }
+  std::lock_guard<std::mutex> lock(report_mutex);
+  std::cerr << state->job.output_file_name << " completed.\n";
+}
+
+void FinishFrame(JobState* state, WorkStealingPool* pool) {
+  if (--state->frames_left == 0) {
+    pool->Submit([state] { WriteJob(state); });
+  }
+}
+
+// Queue the render task for one frame. Rendering queues the quantize and
+// encode task on the same worker, where it usually runs next while the
+// frame is still in cache, unless an idle worker steals it first. A message
+// frame queues the render of the next frame before that, so the frames of
+// one message follow each other while their encoding runs alongside.
+void SubmitFrame(JobState* state, int frame, WorkStealingPool* pool) {
+  pool->Submit([state, frame, pool] {
+    try {
+      // Tasks must be copyable, so the frame travels behind a shared_ptr.
+      auto pixels =
+          std::make_shared<FrameBuffer>(RenderJobFrame(state, frame));
+      if (state->job.type == JobType::kMessage &&
+          frame + 1 < state->job.frame_count) {
+        SubmitFrame(state, frame + 1, pool);
+      }
+      pool->Submit([state, frame, pool, pixels] {
+        try {
+          Magick::Image image = FrameToImage(*pixels);
+          QuantizeForGif(&image);
+          state->frames.at(frame) = EncodeGifFrame(&image);
+        } catch (const std::exception& error) {
+          RecordJobError(state, error.what());
+        }
+        FinishFrame(state, pool);
+      });
+    } catch (const std::exception& error) {
+      // The rest of a failed message is not rendered; the job is not
+      // written either way.
+      RecordJobError(state, error.what());
+      FinishFrame(state, pool);
+    }
+  });
+}
+
+// Queue the preparation of a job, which then queues its frames: every
+// frame of a gradient at once, or the first frame of a message.
+void SubmitJob(JobState* state, WorkStealingPool* pool) {
+  pool->Submit([state, pool] {
+    try {
+      PrepareJob(state);
+    } catch (const std::exception& error) {
+      RecordJobError(state, error.what());
+      return;
+    }
+    if (state->job.type == JobType::kGradient) {
+      for (int frame = 0; frame < state->job.frame_count; frame++) {
+        SubmitFrame(state, frame, pool);
+      }
+    } else {
+      SubmitFrame(state, 0, pool);
+    }
+  });
+}
+
+int main(int argc, char* argv[]) {
+  Magick::InitializeMagick(*argv);
+  CommandLine command_line = ParseCommandLine({argv, argv + argc});
+  const std::vector<std::string>& args = command_line.arguments;
+  if (args.size() < 2) {
+    std::cout << "Please provide a path to a manifest file.\n";
+    return 1;
+  }
+  int thread_count{0};
+  if (!IntegerOptionValue(command_line, "threads", DefaultThreadCount(),
+                          &thread_count) ||
+      thread_count < 1) {
+    std::cout << "The number of threads must be a positive integer.\n";
+    return 1;
+  }
+  std::ifstream manifest(args.at(1));
+  if (!manifest.is_open()) {
+    std::cout << "Could not open " << args.at(1) << ".\n";
+    return 1;
+  }
+  std::vector<BatchJob> jobs;
+  std::string error_message;
+  if (!ReadManifest(manifest, &jobs, &error_message)) {
+    std::cout << error_message << "\n";
+    return 1;
+  }
+  // Start the biggest jobs first so that the small ones fill in the gaps at
+  // the end instead of a big job running alone.
+  std::stable_sort(jobs.begin(), jobs.end(),
+                   [](const BatchJob& a, const BatchJob& b) {
+                     return double(a.width) * a.height * a.frame_count >
+                            double(b.width) * b.height * b.frame_count;
+                   });
+
+  std::vector<std::unique_ptr<JobState>> states;
+  {
+    WorkStealingPool pool(thread_count);
+    for (const BatchJob& job : jobs) {
+      auto state = std::make_unique<JobState>();
+      state->job = job;
+      state->frames.resize(job.frame_count);
+      state->frames_left = job.frame_count;
+      SubmitJob(state.get(), &pool);
+      states.push_back(std::move(state));
+    }
+    pool.Wait();
+  }
+
+  int failed_jobs{0};
+  for (const std::unique_ptr<JobState>& state : states) {
+    if (!state->error_message.empty()) {
+      std::cout << state->job.output_file_name
+                << " failed: " << state->error_message << "\n";
+      failed_jobs++;
+    }
+  }
+  std::cout << jobs.size() - failed_jobs << " of " << jobs.size()
+            << " jobs completed.\n";
+  return failed_jobs == 0 ? 0 : 1;
+}
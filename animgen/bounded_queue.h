@@ -0,0 +1,69 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// A fixed capacity queue connecting pipeline stages.
+//
+
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/// A first in, first out queue shared between threads that holds at most a
+/// fixed number of items. Push() waits while the queue is full, which keeps a
+/// fast producer from running ahead of a slow consumer.
+template <typename T>
+class BoundedQueue {
+ public:
+  /// Create a queue that holds at most \p capacity items.
+  explicit BoundedQueue(std::size_t capacity) : capacity_{capacity} {}
+
+  /// Add \p item to the back of the queue, waiting for room if needed.
+  void Push(T&& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return items_.size() < capacity_; });
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+  }
+
+  /// Remove the item at the front of the queue into \p item, waiting for one
+  /// if needed. Returns false once the queue is closed and empty.
+  bool Pop(T* item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+    if (items_.empty()) {
+      return false;
+    }
+    *item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  /// Signal that no more items will be pushed.
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+  }
+
+ private:
+  std::size_t capacity_;
+  bool closed_{false};
+  std::deque<T> items_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+};
+
+#endif
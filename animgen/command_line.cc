@@ -0,0 +1,102 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Command line options shared by the animation programs.
+//
+
+#include "command_line.h"
+
+#include <cstddef>
+#include <stdexcept>
+
+CommandLine ParseCommandLine(const std::vector<std::string>& args) {
+  CommandLine command_line;
+  for (const std::string& arg : args) {
+    if (arg.size() > 2 && arg.compare(0, 2, "--") == 0) {
+      std::string::size_type equals = arg.find('=');
+      if (equals == std::string::npos) {
+        command_line.options[arg.substr(2)] = "";
+      } else {
+        command_line.options[arg.substr(2, equals - 2)] =
+            arg.substr(equals + 1);
+      }
+    } else {
+      command_line.arguments.push_back(arg);
+    }
+  }
+  return command_line;
+}
+
+bool HasOption(const CommandLine& command_line, const std::string& name) {
+  return command_line.options.count(name) > 0;
+}
+
+std::string OptionValue(const CommandLine& command_line,
+                        const std::string& name,
+                        const std::string& default_value) {
+  auto option = command_line.options.find(name);
+  if (option == command_line.options.end()) {
+    return default_value;
+  }
+  return option->second;
+}
+
+namespace {
+
+// Parse all of text as an int.
+bool ParseInteger(const std::string& text, int* value) {
+  try {
+    std::size_t parsed_length{0};
+    int parsed_value = std::stoi(text, &parsed_length);
+    if (parsed_length != text.size()) {
+      return false;
+    }
+    *value = parsed_value;
+  } catch (const std::logic_error&) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool IntegerOptionValue(const CommandLine& command_line,
+                        const std::string& name, int default_value,
+                        int* value) {
+  if (!HasOption(command_line, name)) {
+    *value = default_value;
+    return true;
+  }
+  return ParseInteger(command_line.options.at(name), value);
+}
+
+bool FrameRangeOptionValue(const CommandLine& command_line,
+                           const std::string& name, int frame_count,
+                           int* first_frame, int* end_frame) {
+  if (!HasOption(command_line, name)) {
+    *first_frame = 0;
+    *end_frame = -1;
+    return true;
+  }
+  const std::string& text = command_line.options.at(name);
+  // Look for the dash after the first character, so a negative start is
+  // rejected as out of range rather than misread.
+  std::string::size_type dash = text.find('-', 1);
+  int first{0};
+  int last{0};
+  if (dash == std::string::npos ||
+      !ParseInteger(text.substr(0, dash), &first) ||
+      !ParseInteger(text.substr(dash + 1), &last) || first < 0 ||
+      first > last || last >= frame_count) {
+    return false;
+  }
+  *first_frame = first;
+  *end_frame = last + 1;
+  return true;
+}
@@ -0,0 +1,71 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Command line options shared by the animation programs.
+//
+
+#ifndef COMMAND_LINE_H
+#define COMMAND_LINE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/// Check to see if \p file_name ends with the string \p extension. Returns
+/// true if it does, false otherwise. Each program's HasMatchingFileExtension()
+/// forwards to this, so the tools that link both programs' functions share
+/// one copy.
+inline bool HasFileExtension(const std::string& file_name,
+                             const std::string& extension) {
+  return file_name.size() >= extension.size() &&
+         (file_name.compare(file_name.size() - extension.size(),
+                            extension.size(), extension) == 0);
+}
+
+/// The command line split into positional arguments and options.
+///
+/// Options are written as --name=value or, for switches, just --name. The
+/// positional arguments keep their order and still start with the program
+/// name so existing argument checks keep working.
+struct CommandLine {
+  std::vector<std::string> arguments;
+  std::map<std::string, std::string> options;
+};
+
+/// Split \p args into positional arguments and options.
+CommandLine ParseCommandLine(const std::vector<std::string>& args);
+
+/// Check to see if the option \p name was given on the command line.
+bool HasOption(const CommandLine& command_line, const std::string& name);
+
+/// Return the value of the option \p name, or \p default_value if the option
+/// was not given.
+std::string OptionValue(const CommandLine& command_line,
+                        const std::string& name,
+                        const std::string& default_value);
+
+/// Set \p value to the integer value of the option \p name, or to
+/// \p default_value if the option was not given. Returns false if the
+/// option's value is not an integer.
+bool IntegerOptionValue(const CommandLine& command_line,
+                        const std::string& name, int default_value,
+                        int* value);
+
+/// Set \p first_frame and \p end_frame to the frames named by the option
+/// \p name, written START-END with both ends counted from 0 and included,
+/// so --frames=0-4 is the first five frames. \p end_frame is one past the
+/// last frame. Without the option \p first_frame is 0 and \p end_frame is
+/// -1, which the render functions read as the end of the animation, so the
+/// range stays whole if the number of frames is changed later.
+/// Returns false if the value is not a range within the animation.
+bool FrameRangeOptionValue(const CommandLine& command_line,
+                           const std::string& name, int frame_count,
+                           int* first_frame, int* end_frame);
+
+#endif
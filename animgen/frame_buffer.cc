@@ -0,0 +1,59 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Compact frames that are rendered and held without GraphicsMagick.
+//
+
+#include "frame_buffer.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef LINUX
+#include <sys/mman.h>
+#endif
+
+namespace {
+
+// Every frame starts on a cache line.
+const std::size_t kCacheLineBytes = 64;
+// The size of a transparent huge page on x86-64 and most ARM64 kernels.
+const std::size_t kHugePageBytes = std::size_t(2) << 20;
+
+}  // namespace
+
+FrameBuffer::FrameBuffer()
+    : width_{0}, height_{0}, format_{PixelFormat::kRgb8} {}
+
+FrameBuffer::FrameBuffer(int width, int height, PixelFormat format)
+    : width_{width}, height_{height}, format_{format} {
+  std::size_t bytes = size_bytes();
+  std::size_t alignment =
+      bytes >= kHugePageBytes ? kHugePageBytes : kCacheLineBytes;
+  // aligned_alloc() needs a size that is a multiple of the alignment.
+  std::size_t allocated_bytes =
+      (std::max<std::size_t>(bytes, 1) + alignment - 1) / alignment *
+      alignment;
+  void* pixels = std::aligned_alloc(alignment, allocated_bytes);
+  if (pixels == nullptr) {
+    throw std::bad_alloc();
+  }
+#if defined(LINUX) && defined(MADV_HUGEPAGE)
+  if (alignment == kHugePageBytes) {
+    // Only advice; the frame works the same if the kernel says no.
+    madvise(pixels, allocated_bytes, MADV_HUGEPAGE);
+  }
+#endif
+  pixels_.reset(static_cast<unsigned char*>(pixels));
+}
+
+void FrameBuffer::AlignedDelete::operator()(unsigned char* pixels) const {
+  std::free(pixels);
+}
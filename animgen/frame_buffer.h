@@ -0,0 +1,85 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Compact frames that are rendered and held without GraphicsMagick.
+//
+
+#ifndef FRAME_BUFFER_H
+#define FRAME_BUFFER_H
+
+#include <cstddef>
+#include <memory>
+
+/// How the pixels of a FrameBuffer are stored.
+enum class PixelFormat {
+  /// Three bytes per pixel: red, green and blue.
+  kRgb8,
+  /// One byte per pixel: an index into a color table kept elsewhere.
+  kIndexed8
+};
+
+/// The number of bytes one pixel takes in \p format.
+inline int BytesPerPixel(PixelFormat format) {
+  return format == PixelFormat::kRgb8 ? 3 : 1;
+}
+
+/// A FrameBuffer holds the pixels of one frame in a single aligned block,
+/// row by row with no padding between rows. A frame takes 3 bytes per pixel
+/// as RGB8 or 1 as palette indices, where a Magick::Image with 16-bit
+/// quantums takes 8 plus its metadata; frames only become Magick::Images
+/// when an output needs one.
+///
+/// Frames of 2 MiB or more are aligned to 2 MiB and, on Linux, offered to
+/// the kernel for transparent huge pages, which saves TLB misses when
+/// shading 4K and larger canvases.
+class FrameBuffer {
+ public:
+  /// An empty frame with no pixels.
+  FrameBuffer();
+
+  /// Allocate a \p width by \p height frame in \p format. The pixels are
+  /// not cleared.
+  FrameBuffer(int width, int height, PixelFormat format);
+
+  FrameBuffer(FrameBuffer&& other) = default;
+  FrameBuffer& operator=(FrameBuffer&& other) = default;
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  PixelFormat format() const { return format_; }
+
+  /// The number of bytes from the start of one row to the start of the next.
+  std::size_t row_bytes() const {
+    return std::size_t(width_) * BytesPerPixel(format_);
+  }
+
+  /// The number of bytes of pixels.
+  std::size_t size_bytes() const { return row_bytes() * height_; }
+
+  unsigned char* data() { return pixels_.get(); }
+  const unsigned char* data() const { return pixels_.get(); }
+
+  /// The first byte of row \p row.
+  unsigned char* row(int row) { return pixels_.get() + row_bytes() * row; }
+  const unsigned char* row(int row) const {
+    return pixels_.get() + row_bytes() * row;
+  }
+
+ private:
+  struct AlignedDelete {
+    void operator()(unsigned char* pixels) const;
+  };
+
+  int width_;
+  int height_;
+  PixelFormat format_;
+  std::unique_ptr<unsigned char[], AlignedDelete> pixels_;
+};
+
+#endif
@@ -0,0 +1,86 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Hashes of rendered frames, for checking output without encoding it.
+//
+
+#include "frame_digest.h"
+
+#include <stdexcept>
+#include <utility>
+
+// The 64-bit FNV-1a prime.
+const unsigned long long kDigestPrime = 1099511628211ULL;
+
+unsigned long long DigestBytes(const unsigned char* data, std::size_t size,
+                               unsigned long long digest) {
+  for (std::size_t byte = 0; byte < size; byte++) {
+    digest = (digest ^ data[byte]) * kDigestPrime;
+  }
+  return digest;
+}
+
+std::string DigestText(unsigned long long digest) {
+  const char kHexDigits[] = "0123456789abcdef";
+  std::string text(16, '0');
+  for (int digit = 15; digit >= 0; digit--) {
+    text[digit] = kHexDigits[digest & 0xF];
+    digest >>= 4;
+  }
+  return text;
+}
+
+DigestSink::DigestSink(std::ostream& output, int first_frame,
+                       FramePool* frame_pool)
+    : output_{output},
+      next_frame_{first_frame},
+      frame_pool_{frame_pool},
+      animation_digest_{kEmptyDigest} {}
+
+void DigestSink::Consume(FrameBuffer&& frame) {
+  WriteFrameDigest(DigestBytes(frame.data(), frame.size_bytes()));
+  frame_pool_->Release(std::move(frame));
+}
+
+void DigestSink::ConsumeIndexed(
+    FrameBuffer&& frame, const std::vector<unsigned char>& color_table) {
+  row_rgb_.resize(std::size_t(frame.width()) * 3);
+  unsigned long long digest{kEmptyDigest};
+  for (int row = 0; row < frame.height(); row++) {
+    const unsigned char* indices = frame.row(row);
+    unsigned char* rgb = row_rgb_.data();
+    for (int column = 0; column < frame.width(); column++) {
+      const unsigned char* color =
+          color_table.data() + 3 * std::size_t(indices[column]);
+      *rgb++ = color[0];
+      *rgb++ = color[1];
+      *rgb++ = color[2];
+    }
+    digest = DigestBytes(row_rgb_.data(), row_rgb_.size(), digest);
+  }
+  WriteFrameDigest(digest);
+  frame_pool_->Release(std::move(frame));
+}
+
+void DigestSink::Finish() {
+  output_ << "animation " << DigestText(animation_digest_) << "\n";
+  output_.flush();
+  if (!output_) {
+    throw std::runtime_error("Could not write the digests.");
+  }
+}
+
+void DigestSink::WriteFrameDigest(unsigned long long digest) {
+  unsigned char bytes[8];
+  for (int byte = 0; byte < 8; byte++) {
+    bytes[byte] = (unsigned char)(digest >> (8 * byte));
+  }
+  animation_digest_ = DigestBytes(bytes, sizeof(bytes), animation_digest_);
+  output_ << "frame " << next_frame_++ << " " << DigestText(digest) << "\n";
+}
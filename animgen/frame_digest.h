@@ -0,0 +1,68 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Hashes of rendered frames, for checking output without encoding it.
+//
+
+#ifndef FRAME_DIGEST_H
+#define FRAME_DIGEST_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "frame_buffer.h"
+#include "frame_pool.h"
+#include "frame_sink.h"
+
+/// The starting value of a digest: the 64-bit FNV-1a offset basis.
+const unsigned long long kEmptyDigest = 14695981039346656037ULL;
+
+/// Fold the \p size bytes at \p data into the 64-bit FNV-1a hash \p digest
+/// and return the result.
+unsigned long long DigestBytes(const unsigned char* data, std::size_t size,
+                               unsigned long long digest = kEmptyDigest);
+
+/// \p digest as 16 lower case hexadecimal digits.
+std::string DigestText(unsigned long long digest);
+
+/// Writes a digest of the RGB pixels of every frame, and then of the whole
+/// animation, instead of an image. Nothing is quantized, encoded or written
+/// to a file, so checking that a renderer still draws the same pixels is
+/// much quicker than writing and comparing a GIF.
+///
+/// Each frame is written as a line "frame N DIGEST" as soon as it arrives,
+/// where DIGEST is DigestBytes() of its pixels, row by row, three bytes per
+/// pixel. Indexed frames are looked up in their color table first, so a
+/// digest does not depend on how the frame was stored. Finish() writes
+/// "animation DIGEST", the digest of the frame digests as 8 little endian
+/// bytes each.
+class DigestSink : public FrameSink {
+ public:
+  /// Write digests to \p output, numbering frames from \p first_frame, and
+  /// give frames back to \p frame_pool.
+  DigestSink(std::ostream& output, int first_frame, FramePool* frame_pool);
+  void Consume(FrameBuffer&& frame) override;
+  void ConsumeIndexed(FrameBuffer&& frame,
+                      const std::vector<unsigned char>& color_table) override;
+  void Finish() override;
+
+ private:
+  void WriteFrameDigest(unsigned long long digest);
+
+  std::ostream& output_;
+  int next_frame_;
+  FramePool* frame_pool_;
+  unsigned long long animation_digest_;
+  // One row of an indexed frame looked up in its color table.
+  std::vector<unsigned char> row_rgb_;
+};
+
+#endif
@@ -0,0 +1,39 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Reusable frames shared by the animation programs.
+//
+
+#include "frame_pool.h"
+
+#include <utility>
+
+FramePool::FramePool(int width, int height, PixelFormat format)
+    : columns_{width}, rows_{height}, format_{format} {}
+
+FrameBuffer FramePool::Acquire() {
+  {
+    std::lock_guard<std::mutex> lock(free_frames_mutex_);
+    if (!free_frames_.empty()) {
+      FrameBuffer frame{std::move(free_frames_.back())};
+      free_frames_.pop_back();
+      return frame;
+    }
+  }
+  return FrameBuffer(columns_, rows_, format_);
+}
+
+void FramePool::Release(FrameBuffer&& frame) {
+  if (!frame.data() || frame.width() != columns_ || frame.height() != rows_ ||
+      frame.format() != format_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(free_frames_mutex_);
+  free_frames_.push_back(std::move(frame));
+}
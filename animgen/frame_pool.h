@@ -0,0 +1,60 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Reusable frames shared by the animation programs.
+//
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <mutex>
+#include <vector>
+
+#include "frame_buffer.h"
+
+/// A FramePool hands out frames of a fixed size and format and takes them
+/// back once the caller is done with them so their pixels can be reused by
+/// the next frame. A FramePool may be shared between threads, for example a
+/// renderer that acquires frames and a sink that releases them.
+///
+/// Frames returned by Acquire() are never cleared; the caller is expected to
+/// write every pixel.
+class FramePool {
+ public:
+  /// Create a pool of frames that are \p width columns by \p height rows of
+  /// \p format pixels.
+  FramePool(int width, int height, PixelFormat format = PixelFormat::kRgb8);
+
+  /// Return a frame from the pool, allocating a new one if the pool is empty.
+  /// The contents of the returned frame's pixels are undefined.
+  FrameBuffer Acquire();
+
+  /// Give \p frame back to the pool so its pixels can be reused. Frames of
+  /// another size or format, and frames whose pixels were moved away, are
+  /// dropped.
+  void Release(FrameBuffer&& frame);
+
+  /// The number of columns (x direction) of every frame in the pool.
+  int columns() const { return columns_; }
+
+  /// The number of rows (y direction) of every frame in the pool.
+  int rows() const { return rows_; }
+
+  /// The format of every frame in the pool.
+  PixelFormat format() const { return format_; }
+
+ private:
+  int columns_;
+  int rows_;
+  PixelFormat format_;
+  std::mutex free_frames_mutex_;
+  std::vector<FrameBuffer> free_frames_;
+};
+
+#endif
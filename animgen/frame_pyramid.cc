@@ -0,0 +1,167 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Smaller copies of every frame, written alongside the full size output.
+//
+
+#include "frame_pyramid.h"
+
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+void DownsampleHalf(const FrameBuffer& source, FrameBuffer* half) {
+  // Each pair of rows is summed first in a plain loop over bytes, which the
+  // compiler turns into vector adds, then neighboring pixels are summed.
+  std::size_t used_bytes = std::size_t(half->width()) * 2 * 3;
+  std::vector<unsigned short> row_sums(used_bytes);
+  for (int row = 0; row < half->height(); row++) {
+    const unsigned char* top = source.row(2 * row);
+    const unsigned char* bottom = source.row(2 * row + 1);
+    for (std::size_t byte = 0; byte < used_bytes; byte++) {
+      row_sums[byte] = (unsigned short)(top[byte] + bottom[byte]);
+    }
+    unsigned char* output = half->row(row);
+    for (int column = 0; column < half->width(); column++) {
+      const unsigned short* block = row_sums.data() + 6 * std::size_t(column);
+      for (int channel = 0; channel < 3; channel++) {
+        output[3 * column + channel] =
+            (unsigned char)((block[channel] + block[channel + 3] + 2) >> 2);
+      }
+    }
+  }
+}
+
+void DecimateHalf(const FrameBuffer& source, FrameBuffer* half) {
+  for (int row = 0; row < half->height(); row++) {
+    const unsigned char* input = source.row(2 * row);
+    unsigned char* output = half->row(row);
+    for (int column = 0; column < half->width(); column++) {
+      output[column] = input[2 * column];
+    }
+  }
+}
+
+int MaxPyramidLevels(int width, int height) {
+  int levels{1};
+  while (width >= 2 && height >= 2) {
+    width /= 2;
+    height /= 2;
+    levels++;
+  }
+  return levels;
+}
+
+std::string PyramidLevelFileName(const std::string& output_file_name,
+                                 int width, int height) {
+  std::string size =
+      "-" + std::to_string(width) + "x" + std::to_string(height);
+  std::string::size_type dot = output_file_name.rfind('.');
+  std::string::size_type slash = output_file_name.rfind('/');
+  if (dot == std::string::npos ||
+      (slash != std::string::npos && dot < slash)) {
+    return output_file_name + size;
+  }
+  return output_file_name.substr(0, dot) + size +
+         output_file_name.substr(dot);
+}
+
+PyramidSink::PyramidSink(std::vector<Level> levels)
+    : levels_{std::move(levels)} {}
+
+void PyramidSink::Consume(FrameBuffer&& frame) {
+  FrameBuffer current{std::move(frame)};
+  for (std::size_t level = 0; level < levels_.size(); level++) {
+    FrameBuffer smaller;
+    if (level + 1 < levels_.size()) {
+      smaller = levels_[level + 1].pool->Acquire();
+      DownsampleHalf(current, &smaller);
+    }
+    levels_[level].sink->Consume(std::move(current));
+    current = std::move(smaller);
+  }
+}
+
+void PyramidSink::ConsumeIndexed(
+    FrameBuffer&& frame, const std::vector<unsigned char>& color_table) {
+  FrameBuffer current{std::move(frame)};
+  for (std::size_t level = 0; level < levels_.size(); level++) {
+    FrameBuffer smaller;
+    if (level + 1 < levels_.size()) {
+      smaller = levels_[level + 1].pool->Acquire();
+      DecimateHalf(current, &smaller);
+    }
+    levels_[level].sink->ConsumeIndexed(std::move(current), color_table);
+    current = std::move(smaller);
+  }
+}
+
+void PyramidSink::Finish() {
+  std::exception_ptr error;
+  for (Level& level : levels_) {
+    try {
+      level.sink->Finish();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+void PyramidSink::UseFastQuantization() {
+  for (Level& level : levels_) {
+    level.sink->UseFastQuantization();
+  }
+}
+
+void PyramidSink::UseProfiler(FrameProfiler* profiler) {
+  levels_.front().sink->UseProfiler(profiler);
+}
+
+std::unique_ptr<FrameSink> OpenPyramidSink(OutputFormat format,
+                                           const std::string& output_file_name,
+                                           int width, int height,
+                                           int frame_rate, int level_count,
+                                           FramePool* frame_pool,
+                                           std::string* error_message) {
+  if (level_count == 1) {
+    return OpenFrameSink(format, output_file_name, width, height, frame_rate,
+                         frame_pool, error_message);
+  }
+  if (WritesToStandardOutput(format, output_file_name)) {
+    *error_message = "More than one size cannot be written to standard output.";
+    return nullptr;
+  }
+  std::vector<PyramidSink::Level> levels;
+  for (int level = 0; level < level_count; level++) {
+    PyramidSink::Level pyramid_level;
+    FramePool* level_pool = frame_pool;
+    std::string level_file_name = output_file_name;
+    if (level > 0) {
+      width /= 2;
+      height /= 2;
+      pyramid_level.pool =
+          std::make_unique<FramePool>(width, height, frame_pool->format());
+      level_pool = pyramid_level.pool.get();
+      level_file_name = PyramidLevelFileName(output_file_name, width, height);
+    }
+    pyramid_level.sink =
+        OpenFrameSink(format, level_file_name, width, height, frame_rate,
+                      level_pool, error_message);
+    if (!pyramid_level.sink) {
+      return nullptr;
+    }
+    levels.push_back(std::move(pyramid_level));
+  }
+  return std::make_unique<PyramidSink>(std::move(levels));
+}
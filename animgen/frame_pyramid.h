@@ -0,0 +1,87 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Smaller copies of every frame, written alongside the full size output.
+//
+
+#ifndef FRAME_PYRAMID_H
+#define FRAME_PYRAMID_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "frame_buffer.h"
+#include "frame_pool.h"
+#include "frame_sink.h"
+#include "frame_stream.h"
+
+/// Shrink the RGB8 \p source to half its width and height into \p half,
+/// averaging each 2 by 2 block of pixels. An odd last row or column is
+/// dropped. \p half must be source.width() / 2 by source.height() / 2.
+void DownsampleHalf(const FrameBuffer& source, FrameBuffer* half);
+
+/// Shrink the kIndexed8 \p source to half its width and height into \p half
+/// by keeping the top left pixel of each 2 by 2 block, since palette indices
+/// cannot be averaged.
+void DecimateHalf(const FrameBuffer& source, FrameBuffer* half);
+
+/// The largest number of sizes, each half of the one before, that a
+/// \p width by \p height frame can be shrunk to while staying at least one
+/// pixel across.
+int MaxPyramidLevels(int width, int height);
+
+/// The name of the output for a \p width by \p height level of the
+/// animation written to \p output_file_name: the size is added before the
+/// extension, so "out.gif" becomes "out-256x144.gif".
+std::string PyramidLevelFileName(const std::string& output_file_name,
+                                 int width, int height);
+
+/// A PyramidSink hands every frame to the sink of the first level, and
+/// shrunk copies of it to the sinks of the levels after it, each half the
+/// size of the one before. The frame is rendered once; every smaller level
+/// is made from the level above it while that is still in cache.
+class PyramidSink : public FrameSink {
+ public:
+  /// One size of the pyramid. pool supplies the level's frames and is null
+  /// for the first level, whose frames come from the renderer.
+  struct Level {
+    std::unique_ptr<FramePool> pool;
+    std::unique_ptr<FrameSink> sink;
+  };
+
+  explicit PyramidSink(std::vector<Level> levels);
+  void Consume(FrameBuffer&& frame) override;
+  void ConsumeIndexed(FrameBuffer&& frame,
+                      const std::vector<unsigned char>& color_table) override;
+
+  /// Finish every level. Throws the first error any of them raises.
+  void Finish() override;
+  void UseFastQuantization() override;
+
+  /// Profile the first, full size, level only.
+  void UseProfiler(FrameProfiler* profiler) override;
+
+ private:
+  std::vector<Level> levels_;
+};
+
+/// Create the sinks for \p level_count sizes of a \p width by \p height
+/// animation in \p format, the first named \p output_file_name and the rest
+/// named by PyramidLevelFileName(). With one level this is the same as
+/// OpenFrameSink(). Returns nullptr and sets \p error_message if an output
+/// cannot be opened.
+std::unique_ptr<FrameSink> OpenPyramidSink(OutputFormat format,
+                                           const std::string& output_file_name,
+                                           int width, int height,
+                                           int frame_rate, int level_count,
+                                           FramePool* frame_pool,
+                                           std::string* error_message);
+
+#endif
@@ -0,0 +1,181 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Renders shaders into frames and hands them to a FrameSink.
+//
+
+#ifndef FRAME_RENDERER_H
+#define FRAME_RENDERER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "frame_buffer.h"
+#include "frame_pool.h"
+#include "frame_shader.h"
+#include "frame_sink.h"
+#include "perf_counters.h"
+
+/// The number of threads to render with when none is given: one per
+/// hardware thread.
+inline int DefaultThreadCount() {
+  return std::max(1, int(std::thread::hardware_concurrency()));
+}
+
+/// Convert a channel between 0.0 and 1.0 to a byte. The channel goes
+/// through a 16-bit quantum first, as Magick::ColorRGB stores it, and is
+/// then rounded to 8 bits the way GraphicsMagick writes such a quantum to a
+/// GIF, so frames hold the bytes a 16-bit GraphicsMagick build wrote for
+/// them when they were Magick::Images.
+inline unsigned char ChannelToByte(double channel) {
+  unsigned int quantum = static_cast<unsigned int>(channel * 65535);
+  return static_cast<unsigned char>((quantum + 128) / 257);
+}
+
+/// Shade rows \p first_row up to but not including \p last_row of \p frame
+/// into the RGB8 \p pixels.
+template <typename Shader>
+void ShadeRows(Shader& shader, int frame, int width, int first_row,
+               int last_row, unsigned char* pixels) {
+  for (int row = first_row; row < last_row; row++) {
+    unsigned char* row_pixels = pixels + std::size_t(row) * width * 3;
+    for (int column = 0; column < width; column++) {
+      PixelColor color = shader(column, row, frame);
+      row_pixels[3 * column] = ChannelToByte(color.red);
+      row_pixels[3 * column + 1] = ChannelToByte(color.green);
+      row_pixels[3 * column + 2] = ChannelToByte(color.blue);
+    }
+  }
+}
+
+/// Shade every pixel of the RGB8 \p image for animation frame \p frame.
+/// Shaders with independent pixels are split into bands of rows across
+/// \p thread_count threads.
+template <typename Shader>
+void ShadeFrame(Shader& shader, int frame, int thread_count,
+                FrameBuffer* image) {
+  int width = image->width();
+  int height = image->height();
+  shader.BeginFrame(frame);
+  unsigned char* pixels = image->data();
+  if (!Shader::kIndependentPixels || thread_count <= 1 || height < 2) {
+    ShadeRows(shader, frame, width, 0, height, pixels);
+  } else {
+    int band_count = std::min(thread_count, height);
+    std::vector<std::thread> bands;
+    bands.reserve(band_count - 1);
+    for (int band = 1; band < band_count; band++) {
+      bands.emplace_back([&shader, frame, width, height, band, band_count,
+                          pixels] {
+        ShadeRows(shader, frame, width, height * band / band_count,
+                  height * (band + 1) / band_count, pixels);
+      });
+    }
+    ShadeRows(shader, frame, width, 0, height / band_count, pixels);
+    for (std::thread& band : bands) {
+      band.join();
+    }
+  }
+}
+
+/// Render every frame of the animation described by \p spec with \p shader,
+/// apply \p overlay to each finished frame and hand it to \p sink. Only the
+/// frames from spec.first_frame to EndFrame() are rendered, each with the
+/// same pixels it has in a full run. Frames come from \p frame_pool.
+/// Progress is reported on standard error if spec.report_progress is set,
+/// and the rendering of each frame, not counting the sink, is measured as
+/// the "render" phase of spec.profiler if there is one.
+template <typename Shader, typename Overlay>
+void RenderAnimation(const AnimationSpec& spec, Shader& shader,
+                     Overlay overlay, FramePool* frame_pool, FrameSink* sink) {
+  for (int frame = spec.first_frame; frame < EndFrame(spec); frame++) {
+    if (spec.report_progress) {
+      std::cerr << "Image " << frame + 1 << "...";
+    }
+    ProfileScope render(spec.profiler, "render");
+    FrameBuffer image = frame_pool->Acquire();
+    ShadeFrame(shader, frame, spec.thread_count, &image);
+    overlay(&image);
+    render.Stop();
+    sink->Consume(std::move(image));
+    if (spec.report_progress) {
+      std::cerr << "completed.\n";
+    }
+  }
+  sink->Finish();
+}
+
+/// Render every frame of the animation described by \p spec with \p shader
+/// and hand it to \p sink.
+template <typename Shader>
+void RenderAnimation(const AnimationSpec& spec, Shader& shader,
+                     FramePool* frame_pool, FrameSink* sink) {
+  RenderAnimation(
+      spec, shader, [](FrameBuffer*) {}, frame_pool, sink);
+}
+
+/// Render every frame of the animation described by \p spec with
+/// \p fill_frame, apply \p overlay to each finished frame and hand it to
+/// \p sink. For generators that build a whole frame at once rather than
+/// shading one pixel at a time: \p fill_frame is called as
+/// fill_frame(frame, image) and writes every pixel of an RGB8 frame from
+/// \p frame_pool. Frames are picked, progress is reported and frames are
+/// profiled as for RenderAnimation().
+template <typename FrameFiller, typename Overlay>
+void FillAnimation(const AnimationSpec& spec, FrameFiller fill_frame,
+                   Overlay overlay, FramePool* frame_pool, FrameSink* sink) {
+  for (int frame = spec.first_frame; frame < EndFrame(spec); frame++) {
+    if (spec.report_progress) {
+      std::cerr << "Image " << frame + 1 << "...";
+    }
+    ProfileScope render(spec.profiler, "render");
+    FrameBuffer image = frame_pool->Acquire();
+    fill_frame(frame, &image);
+    overlay(&image);
+    render.Stop();
+    sink->Consume(std::move(image));
+    if (spec.report_progress) {
+      std::cerr << "completed.\n";
+    }
+  }
+  sink->Finish();
+}
+
+/// Render every frame of the animation described by \p spec as palette
+/// indices into \p color_table and hand them to \p sink. \p render_frame is
+/// called as render_frame(frame, indices) and fills in one index per pixel,
+/// row by row. Frames come from \p frame_pool, which must hold kIndexed8
+/// frames. Frames are picked, progress is reported and frames are profiled
+/// as for RenderAnimation().
+template <typename IndexedRenderer>
+void RenderIndexedAnimation(const AnimationSpec& spec,
+                            const std::vector<unsigned char>& color_table,
+                            IndexedRenderer render_frame,
+                            FramePool* frame_pool, FrameSink* sink) {
+  for (int frame = spec.first_frame; frame < EndFrame(spec); frame++) {
+    if (spec.report_progress) {
+      std::cerr << "Image " << frame + 1 << "...";
+    }
+    ProfileScope render(spec.profiler, "render");
+    FrameBuffer indices = frame_pool->Acquire();
+    render_frame(frame, indices.data());
+    render.Stop();
+    sink->ConsumeIndexed(std::move(indices), color_table);
+    if (spec.report_progress) {
+      std::cerr << "completed.\n";
+    }
+  }
+  sink->Finish();
+}
+
+#endif
@@ -0,0 +1,70 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Describes animations as per pixel shaders.
+//
+
+#ifndef FRAME_SHADER_H
+#define FRAME_SHADER_H
+
+class FrameProfiler;
+
+/// The color of one pixel. Each channel is between 0.0 and 1.0.
+struct PixelColor {
+  double red;
+  double green;
+  double blue;
+};
+
+/// The size of an animation, how many threads may render it and whether
+/// progress is reported on standard error.
+struct AnimationSpec {
+  int width;
+  int height;
+  int frame_count;
+  int thread_count;
+  bool report_progress = true;
+  /// Only frames first_frame up to but not including end_frame are
+  /// rendered, so one animation can be split across processes. An end_frame
+  /// of -1 stands for frame_count.
+  int first_frame = 0;
+  int end_frame = -1;
+  /// Measures the rendering of every frame with hardware counters when not
+  /// null.
+  FrameProfiler* profiler = nullptr;
+};
+
+/// The frame after the last one \p spec renders.
+inline int EndFrame(const AnimationSpec& spec) {
+  return spec.end_frame < 0 ? spec.frame_count : spec.end_frame;
+}
+
+// A shader is any type that can be called as
+//
+//   PixelColor shader(int column, int row, int frame);
+//
+// and that declares
+//
+//   static constexpr bool kIndependentPixels;
+//   void BeginFrame(int frame);
+//
+// BeginFrame() is called before the first pixel of every frame. Frames may be
+// rendered in any order, so a shader that keeps state between frames uses
+// BeginFrame() to move that state to the start of the requested frame.
+//
+// Shaders whose pixels do not depend on each other set kIndependentPixels to
+// true; their operator() must be const and they may be called from several
+// threads at once, in any order. Shaders that carry state from one pixel to
+// the next, such as a random number stream, set it to false and are called
+// one row at a time, left to right, top to bottom.
+//
+// Shaders are passed to the renderer as template parameters so that the
+// compiler can inline them into the pixel loop.
+
+#endif
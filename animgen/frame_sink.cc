@@ -0,0 +1,276 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Destinations for rendered frames.
+//
+
+#include "frame_sink.h"
+
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+Magick::Image FrameToImage(const FrameBuffer& frame) {
+  return Magick::Image(frame.width(), frame.height(), "RGB", Magick::CharPixel,
+                       frame.data());
+}
+
+// The color tree depth searched by fast quantization; GraphicsMagick picks
+// a depth of about 8 for 256 colors.
+const int kFastQuantizeTreeDepth = 4;
+
+void QuantizeForGif(Magick::Image* frame, bool fast) {
+  frame->quantizeColors(256);
+  if (fast) {
+    frame->quantizeTreeDepth(kFastQuantizeTreeDepth);
+    frame->quantizeDither(false);
+  }
+  frame->quantize();
+}
+
+GifFrame EncodeGifFrame(Magick::Image* frame) {
+  frame->magick("GIF");
+  Magick::Blob blob;
+  frame->write(&blob);
+  const unsigned char* data = static_cast<const unsigned char*>(blob.data());
+  std::vector<unsigned char> bytes(data, data + blob.length());
+  GifFile gif;
+  if (!ParseGif(bytes, &gif)) {
+    throw std::runtime_error("GraphicsMagick did not produce a GIF frame.");
+  }
+  return std::move(gif.frames.front());
+}
+
+// How many frames may wait between two pipeline stages.
+const std::size_t kFramesBetweenStages = 2;
+
+GifPipelineSink::GifPipelineSink(const std::string& output_file_name,
+                                 int width, int height, FramePool* frame_pool)
+    : output_file_name_{output_file_name},
+      width_{width},
+      height_{height},
+      frame_pool_{frame_pool},
+      output_file_{output_file_name, std::ios::binary},
+      output_{output_file_},
+      gif_writer_{output_, width, height},
+      to_quantize_{kFramesBetweenStages},
+      to_encode_{kFramesBetweenStages},
+      to_write_{kFramesBetweenStages} {
+  StartStages();
+}
+
+GifPipelineSink::GifPipelineSink(std::ostream& output, int width, int height,
+                                 FramePool* frame_pool)
+    : output_file_name_{"the GIF"},
+      width_{width},
+      height_{height},
+      frame_pool_{frame_pool},
+      output_{output},
+      gif_writer_{output_, width, height},
+      to_quantize_{kFramesBetweenStages},
+      to_encode_{kFramesBetweenStages},
+      to_write_{kFramesBetweenStages} {
+  StartStages();
+}
+
+GifPipelineSink::~GifPipelineSink() { StopStages(); }
+
+bool GifPipelineSink::is_open() const {
+  return &output_ != &output_file_ || output_file_.is_open();
+}
+
+void GifPipelineSink::Consume(FrameBuffer&& frame) {
+  PendingGifFrame pending;
+  pending.pixels = std::move(frame);
+  pending.indexed = false;
+  to_quantize_.Push(std::move(pending));
+}
+
+void GifPipelineSink::ConsumeIndexed(
+    FrameBuffer&& frame, const std::vector<unsigned char>& color_table) {
+  PendingGifFrame pending;
+  pending.pixels = std::move(frame);
+  pending.indexed = true;
+  pending.color_table = color_table;
+  to_quantize_.Push(std::move(pending));
+}
+
+void GifPipelineSink::Finish() {
+  StopStages();
+  if (error_) {
+    std::rethrow_exception(error_);
+  }
+  gif_writer_.Finish();
+  if (!output_) {
+    throw std::runtime_error("Could not write " + output_file_name_ + ".");
+  }
+}
+
+void GifPipelineSink::UseFastQuantization() { fast_quantization_ = true; }
+
+void GifPipelineSink::UseProfiler(FrameProfiler* profiler) {
+  profiler_ = profiler;
+}
+
+void GifPipelineSink::StartStages() {
+  stages_.emplace_back(&GifPipelineSink::Quantize, this);
+  stages_.emplace_back(&GifPipelineSink::Encode, this);
+  stages_.emplace_back(&GifPipelineSink::Write, this);
+}
+
+// Each stage keeps draining its queue after an error so that the stages in
+// front of it never wait for room that will not come.
+void GifPipelineSink::Quantize() {
+  PendingGifFrame frame;
+  while (to_quantize_.Pop(&frame)) {
+    try {
+      if (!failed()) {
+        if (!frame.indexed) {
+          ProfileScope quantize(profiler_, "quantize");
+          frame.image = FrameToImage(frame.pixels);
+          frame_pool_->Release(std::move(frame.pixels));
+          QuantizeForGif(&frame.image, fast_quantization_);
+        }
+        to_encode_.Push(std::move(frame));
+      }
+    } catch (...) {
+      RecordError();
+    }
+    frame = PendingGifFrame();
+  }
+  to_encode_.Close();
+}
+
+void GifPipelineSink::Encode() {
+  PendingGifFrame frame;
+  while (to_encode_.Pop(&frame)) {
+    try {
+      if (!failed()) {
+        ProfileScope encode(profiler_, "encode");
+        GifFrame encoded =
+            frame.indexed ? EncodeIndexedFrame(frame.pixels.data(), width_,
+                                               height_, frame.color_table)
+                          : EncodeGifFrame(&frame.image);
+        encode.Stop();
+        to_write_.Push(std::move(encoded));
+        // RGB frames went back to the pool once they became images.
+        if (frame.indexed) {
+          frame_pool_->Release(std::move(frame.pixels));
+        }
+      }
+    } catch (...) {
+      RecordError();
+    }
+    frame = PendingGifFrame();
+  }
+  to_write_.Close();
+}
+
+void GifPipelineSink::Write() {
+  GifFrame frame;
+  while (to_write_.Pop(&frame)) {
+    try {
+      if (!failed()) {
+        gif_writer_.WriteFrame(frame);
+      }
+    } catch (...) {
+      RecordError();
+    }
+  }
+}
+
+void GifPipelineSink::StopStages() {
+  to_quantize_.Close();
+  for (std::thread& stage : stages_) {
+    stage.join();
+  }
+  stages_.clear();
+}
+
+void GifPipelineSink::RecordError() {
+  std::lock_guard<std::mutex> lock(error_mutex_);
+  if (!error_) {
+    error_ = std::current_exception();
+  }
+}
+
+bool GifPipelineSink::failed() {
+  std::lock_guard<std::mutex> lock(error_mutex_);
+  return bool(error_);
+}
+
+RawStreamSink::RawStreamSink(const std::string& output_file_name,
+                             OutputFormat format, int width, int height,
+                             int frame_rate, FramePool* frame_pool)
+    : to_standard_output_{output_file_name == "-"},
+      frame_writer_{to_standard_output_ ? std::cout : output_file_, format,
+                    width, height, frame_rate},
+      frame_pool_{frame_pool} {
+  if (!to_standard_output_) {
+    output_file_.open(output_file_name, std::ios::binary);
+  }
+}
+
+bool RawStreamSink::is_open() const {
+  return to_standard_output_ || output_file_.is_open();
+}
+
+void RawStreamSink::Consume(FrameBuffer&& frame) {
+  // RGB8 frames are already laid out the way the stream wants them.
+  frame_writer_.WriteFrame(frame.data());
+  frame_pool_->Release(std::move(frame));
+}
+
+void RawStreamSink::ConsumeIndexed(
+    FrameBuffer&& frame, const std::vector<unsigned char>& color_table) {
+  if (frame_rgb_.empty()) {
+    frame_rgb_.resize(frame.size_bytes() * 3);
+  }
+  unsigned char* rgb = frame_rgb_.data();
+  const unsigned char* indices = frame.data();
+  for (std::size_t pixel = 0; pixel < frame.size_bytes(); pixel++) {
+    const unsigned char* color =
+        color_table.data() + 3 * std::size_t(indices[pixel]);
+    *rgb++ = color[0];
+    *rgb++ = color[1];
+    *rgb++ = color[2];
+  }
+  frame_writer_.WriteFrame(frame_rgb_.data());
+  frame_pool_->Release(std::move(frame));
+}
+
+void RawStreamSink::Finish() {}
+
+bool WritesToStandardOutput(OutputFormat format,
+                            const std::string& output_file_name) {
+  return format != OutputFormat::kGif && output_file_name == "-";
+}
+
+std::unique_ptr<FrameSink> OpenFrameSink(OutputFormat format,
+                                         const std::string& output_file_name,
+                                         int width, int height, int frame_rate,
+                                         FramePool* frame_pool,
+                                         std::string* error_message) {
+  if (format == OutputFormat::kGif) {
+    auto sink = std::make_unique<GifPipelineSink>(output_file_name, width,
+                                                  height, frame_pool);
+    if (sink->is_open()) {
+      return sink;
+    }
+  } else {
+    auto sink = std::make_unique<RawStreamSink>(
+        output_file_name, format, width, height, frame_rate, frame_pool);
+    if (sink->is_open()) {
+      return sink;
+    }
+  }
+  *error_message = "Could not open " + output_file_name + ".";
+  return nullptr;
+}
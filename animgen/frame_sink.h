@@ -0,0 +1,182 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Destinations for rendered frames.
+//
+
+#ifndef FRAME_SINK_H
+#define FRAME_SINK_H
+
+#include <Magick++.h>
+
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bounded_queue.h"
+#include "frame_buffer.h"
+#include "frame_pool.h"
+#include "frame_stream.h"
+#include "gif_stream.h"
+#include "perf_counters.h"
+
+/// A FrameSink receives finished frames in order.
+class FrameSink {
+ public:
+  virtual ~FrameSink() = default;
+
+  /// Take the next finished RGB8 frame.
+  virtual void Consume(FrameBuffer&& frame) = 0;
+
+  /// Take the next finished kIndexed8 frame, whose pixels are indices into
+  /// \p color_table (RGB triples, at most 256 colors).
+  virtual void ConsumeIndexed(FrameBuffer&& frame,
+                              const std::vector<unsigned char>& color_table) = 0;
+
+  /// Called once after the last frame has been consumed.
+  virtual void Finish() = 0;
+
+  /// Spend less effort reducing frames to a palette, for a lower quality
+  /// image sooner. Call it before the first frame. Sinks that do not
+  /// quantize ignore it.
+  virtual void UseFastQuantization() {}
+
+  /// Measure the work done on every frame as phases of \p profiler. Call it
+  /// before the first frame. Sinks with nothing worth measuring ignore it.
+  virtual void UseProfiler(FrameProfiler* profiler) {}
+};
+
+/// Copy the RGB8 \p frame into a new Magick::Image, for the outputs that
+/// need GraphicsMagick.
+Magick::Image FrameToImage(const FrameBuffer& frame);
+
+/// Reduce \p frame to the palette of at most 256 colors that a GIF frame
+/// needs, the same way the GIF coder does when given a true color frame.
+/// When \p fast is set a shallower color tree is searched and the frame is
+/// not dithered, which takes less time and shows more banding.
+void QuantizeForGif(Magick::Image* frame, bool fast = false);
+
+/// Encode the already quantized \p frame as a GIF frame.
+GifFrame EncodeGifFrame(Magick::Image* frame);
+
+/// A frame waiting in a GifPipelineSink. RGB8 pixels become a true color
+/// image to quantize; when indexed is true the pixels are palette indices
+/// into color_table that need no quantization.
+struct PendingGifFrame {
+  FrameBuffer pixels;
+  Magick::Image image;
+  bool indexed;
+  std::vector<unsigned char> color_table;
+};
+
+/// Writes frames as an animated GIF through a pipeline of threads. While the
+/// caller renders a frame, the frame before it is being quantized, the one
+/// before that encoded, and the one before that written. The stages are
+/// connected by BoundedQueues, so only a few frames are in memory at once
+/// and a slow stage holds back the ones in front of it. Indexed frames pass
+/// straight through the quantize stage. Frame buffers go back to their
+/// FramePool as soon as they have been copied or encoded.
+class GifPipelineSink : public FrameSink {
+ public:
+  /// Write a \p width by \p height animation to the file named
+  /// \p output_file_name, giving frames back to \p frame_pool. Check
+  /// is_open() before using the sink.
+  GifPipelineSink(const std::string& output_file_name, int width, int height,
+                  FramePool* frame_pool);
+
+  /// Write a \p width by \p height animation to \p output, for example a
+  /// std::ostringstream, giving frames back to \p frame_pool.
+  GifPipelineSink(std::ostream& output, int width, int height,
+                  FramePool* frame_pool);
+  ~GifPipelineSink() override;
+  bool is_open() const;
+  void Consume(FrameBuffer&& frame) override;
+  void ConsumeIndexed(FrameBuffer&& frame,
+                      const std::vector<unsigned char>& color_table) override;
+
+  /// Wait for every frame to be written. Throws the first error raised by
+  /// any stage.
+  void Finish() override;
+  void UseFastQuantization() override;
+
+  /// Measure the quantize and encode stages as the "quantize" and "encode"
+  /// phases.
+  void UseProfiler(FrameProfiler* profiler) override;
+
+ private:
+  void StartStages();
+  void Quantize();
+  void Encode();
+  void Write();
+  void StopStages();
+  void RecordError();
+  bool failed();
+
+  std::string output_file_name_;
+  int width_;
+  int height_;
+  FramePool* frame_pool_;
+  std::ofstream output_file_;
+  // output_file_, or the stream the sink was given.
+  std::ostream& output_;
+  GifStreamWriter gif_writer_;
+  BoundedQueue<PendingGifFrame> to_quantize_;
+  BoundedQueue<PendingGifFrame> to_encode_;
+  BoundedQueue<GifFrame> to_write_;
+  std::vector<std::thread> stages_;
+  std::mutex error_mutex_;
+  std::exception_ptr error_;
+  std::atomic<bool> fast_quantization_{false};
+  std::atomic<FrameProfiler*> profiler_{nullptr};
+};
+
+/// Streams every frame as raw RGB or Y4M as soon as it arrives and gives the
+/// frame back to its FramePool.
+class RawStreamSink : public FrameSink {
+ public:
+  /// Stream to the file named \p output_file_name, or to standard output if
+  /// the name is -. Check is_open() before using the sink.
+  RawStreamSink(const std::string& output_file_name, OutputFormat format,
+                int width, int height, int frame_rate,
+                FramePool* frame_pool);
+  bool is_open() const;
+  void Consume(FrameBuffer&& frame) override;
+  void ConsumeIndexed(FrameBuffer&& frame,
+                      const std::vector<unsigned char>& color_table) override;
+  void Finish() override;
+
+ private:
+  bool to_standard_output_;
+  std::ofstream output_file_;
+  RawFrameWriter frame_writer_;
+  FramePool* frame_pool_;
+  // Indexed frames expanded to RGB; allocated by the first one.
+  std::vector<unsigned char> frame_rgb_;
+};
+
+/// Check to see if \p format output named \p output_file_name goes to
+/// standard output.
+bool WritesToStandardOutput(OutputFormat format,
+                            const std::string& output_file_name);
+
+/// Create the sink for \p format output named \p output_file_name. Returns
+/// nullptr and sets \p error_message if the output cannot be opened.
+std::unique_ptr<FrameSink> OpenFrameSink(OutputFormat format,
+                                         const std::string& output_file_name,
+                                         int width, int height, int frame_rate,
+                                         FramePool* frame_pool,
+                                         std::string* error_message);
+
+#endif
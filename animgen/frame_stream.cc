@@ -0,0 +1,71 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Streams uncompressed frames for video encoders.
+//
+
+#include "frame_stream.h"
+
+bool ParseOutputFormat(const std::string& name, OutputFormat* format) {
+  if (name == "gif") {
+    *format = OutputFormat::kGif;
+  } else if (name == "rgb") {
+    *format = OutputFormat::kRgb;
+  } else if (name == "y4m") {
+    *format = OutputFormat::kY4m;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+RawFrameWriter::RawFrameWriter(std::ostream& output, OutputFormat format,
+                               int width, int height, int frame_rate)
+    : output_{output},
+      format_{format},
+      width_{width},
+      height_{height},
+      frame_rate_{frame_rate},
+      wrote_header_{false} {}
+
+void RawFrameWriter::WriteFrame(const unsigned char* rgb) {
+  if (format_ == OutputFormat::kY4m) {
+    WriteY4mFrame(rgb);
+  } else {
+    output_.write(reinterpret_cast<const char*>(rgb),
+                  std::streamsize(width_) * height_ * 3);
+  }
+  output_.flush();
+}
+
+void RawFrameWriter::WriteY4mFrame(const unsigned char* rgb) {
+  if (!wrote_header_) {
+    output_ << "YUV4MPEG2 W" << width_ << " H" << height_ << " F"
+            << frame_rate_ << ":1 Ip A1:1 C444\n";
+    wrote_header_ = true;
+  }
+  // Convert to BT.601 studio range Y, Cb and Cr planes using the usual
+  // 8-bit fixed point approximation.
+  int pixel_count = width_ * height_;
+  planes_.resize(std::size_t(pixel_count) * 3);
+  unsigned char* y_plane = planes_.data();
+  unsigned char* u_plane = y_plane + pixel_count;
+  unsigned char* v_plane = u_plane + pixel_count;
+  for (int pixel = 0; pixel < pixel_count; pixel++) {
+    int red = rgb[pixel * 3];
+    int green = rgb[pixel * 3 + 1];
+    int blue = rgb[pixel * 3 + 2];
+    y_plane[pixel] = ((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16;
+    u_plane[pixel] = ((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128;
+    v_plane[pixel] = ((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128;
+  }
+  output_ << "FRAME\n";
+  output_.write(reinterpret_cast<const char*>(planes_.data()),
+                std::streamsize(planes_.size()));
+}
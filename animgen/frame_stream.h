@@ -0,0 +1,58 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Streams uncompressed frames for video encoders.
+//
+
+#ifndef FRAME_STREAM_H
+#define FRAME_STREAM_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// The kinds of output the animation programs can produce.
+enum class OutputFormat {
+  /// An animated GIF written once every frame has been rendered.
+  kGif,
+  /// Headerless 8-bit RGB triples, one frame after another.
+  kRgb,
+  /// YUV4MPEG2 with full resolution (4:4:4) chroma.
+  kY4m,
+};
+
+/// Convert \p name ("gif", "rgb" or "y4m") to an OutputFormat. Returns false
+/// and leaves \p format unchanged if \p name is not a known format.
+bool ParseOutputFormat(const std::string& name, OutputFormat* format);
+
+/// Writes frames to a stream as soon as each one is finished so that they do
+/// not need to be kept in memory.
+class RawFrameWriter {
+ public:
+  /// Write \p format frames that are \p width by \p height pixels to
+  /// \p output. The \p frame_rate is recorded in the Y4M header.
+  RawFrameWriter(std::ostream& output, OutputFormat format, int width,
+                 int height, int frame_rate);
+
+  /// Write one frame given as width * height RGB triples, row by row.
+  void WriteFrame(const unsigned char* rgb);
+
+ private:
+  void WriteY4mFrame(const unsigned char* rgb);
+
+  std::ostream& output_;
+  OutputFormat format_;
+  int width_;
+  int height_;
+  int frame_rate_;
+  bool wrote_header_;
+  std::vector<unsigned char> planes_;
+};
+
+#endif
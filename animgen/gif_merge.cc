@@ -0,0 +1,69 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Joins the slices of an animation rendered with --frames into one GIF.
+//
+
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "command_line.h"
+#include "gif_stream.h"
+
+int main(int argc, char* argv[]) {
+  CommandLine command_line = ParseCommandLine({argv, argv + argc});
+  const std::vector<std::string>& args = command_line.arguments;
+  if (args.size() < 3) {
+    std::cout << "Please provide an output file and the GIF files to merge.\n";
+    return 1;
+  }
+  std::string output_file_name{args.at(1)};
+  if (!HasFileExtension(output_file_name, ".gif")) {
+    std::cout << output_file_name
+              << " is missing the required file extension .gif.\n";
+    return 1;
+  }
+  std::vector<GifFile> parts;
+  for (std::size_t arg = 2; arg < args.size(); arg++) {
+    std::ifstream input_file(args.at(arg), std::ios::binary);
+    if (!input_file.is_open()) {
+      std::cout << "Could not open " << args.at(arg) << ".\n";
+      return 1;
+    }
+    std::vector<unsigned char> bytes(
+        (std::istreambuf_iterator<char>(input_file)),
+        std::istreambuf_iterator<char>());
+    GifFile part;
+    if (!ParseGif(bytes, &part)) {
+      std::cout << args.at(arg) << " is not a GIF file.\n";
+      return 1;
+    }
+    parts.push_back(std::move(part));
+  }
+  std::ofstream output_file(output_file_name, std::ios::binary);
+  if (!output_file.is_open()) {
+    std::cout << "Could not open " << output_file_name << ".\n";
+    return 1;
+  }
+  std::string error_message;
+  if (!MergeGifs(parts, output_file, &error_message)) {
+    std::cout << error_message << "\n";
+    return 1;
+  }
+  if (!output_file) {
+    std::cout << "Could not write " << output_file_name << ".\n";
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,497 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Reads and writes the blocks of animated GIF files.
+//
+
+#include "gif_stream.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace {
+
+// Block introducers and labels from the GIF89a specification.
+const unsigned char kExtensionIntroducer = 0x21;
+const unsigned char kImageSeparator = 0x2C;
+const unsigned char kTrailer = 0x3B;
+const unsigned char kGraphicControlLabel = 0xF9;
+const unsigned char kApplicationLabel = 0xFF;
+
+// Reads little endian values from a GIF file while checking bounds.
+class GifReader {
+ public:
+  explicit GifReader(const std::vector<unsigned char>& bytes)
+      : bytes_{bytes}, position_{0} {}
+
+  bool ReadByte(unsigned char* value) {
+    if (position_ >= bytes_.size()) {
+      return false;
+    }
+    *value = bytes_[position_++];
+    return true;
+  }
+
+  bool ReadShort(int* value) {
+    unsigned char low{0};
+    unsigned char high{0};
+    if (!ReadByte(&low) || !ReadByte(&high)) {
+      return false;
+    }
+    *value = low | (high << 8);
+    return true;
+  }
+
+  bool ReadBytes(std::size_t count, std::vector<unsigned char>* values) {
+    if (bytes_.size() - position_ < count) {
+      return false;
+    }
+    values->assign(bytes_.begin() + position_,
+                   bytes_.begin() + position_ + count);
+    position_ += count;
+    return true;
+  }
+
+  // Append data sub-blocks, including the terminating empty one, to
+  // values.
+  bool ReadSubBlocks(std::vector<unsigned char>* values) {
+    unsigned char size{0};
+    do {
+      if (!ReadByte(&size) || bytes_.size() - position_ < size) {
+        return false;
+      }
+      values->push_back(size);
+      values->insert(values->end(), bytes_.begin() + position_,
+                     bytes_.begin() + position_ + size);
+      position_ += size;
+    } while (size != 0);
+    return true;
+  }
+
+ private:
+  const std::vector<unsigned char>& bytes_;
+  std::size_t position_;
+};
+
+// The number of bytes in a color table described by the low three bits of a
+// packed field.
+std::size_t ColorTableBytes(unsigned char packed) {
+  return 3 * (std::size_t(2) << (packed & 0x07));
+}
+
+// The largest LZW code a GIF may use; codes are at most 12 bits wide.
+const int kMaxLzwCodes = 4096;
+const int kMaxLzwCodeWidth = 12;
+
+// Packs variable width LZW codes, least significant bit first, into GIF data
+// sub-blocks of up to 255 bytes.
+class CodeWriter {
+ public:
+  explicit CodeWriter(std::vector<unsigned char>* output)
+      : output_{output}, bit_buffer_{0}, bit_count_{0} {}
+
+  void Write(int code, int code_width) {
+    bit_buffer_ |= static_cast<unsigned long>(code) << bit_count_;
+    bit_count_ += code_width;
+    while (bit_count_ >= 8) {
+      PutByte(bit_buffer_ & 0xFF);
+      bit_buffer_ >>= 8;
+      bit_count_ -= 8;
+    }
+  }
+
+  // Write any remaining bits and the terminating empty sub-block.
+  void Finish() {
+    if (bit_count_ > 0) {
+      PutByte(bit_buffer_ & 0xFF);
+    }
+    if (!block_.empty()) {
+      WriteBlock();
+    }
+    output_->push_back(0);
+  }
+
+ private:
+  void PutByte(unsigned char value) {
+    block_.push_back(value);
+    if (block_.size() == 255) {
+      WriteBlock();
+    }
+  }
+
+  void WriteBlock() {
+    output_->push_back((unsigned char)block_.size());
+    output_->insert(output_->end(), block_.begin(), block_.end());
+    block_.clear();
+  }
+
+  std::vector<unsigned char>* output_;
+  std::vector<unsigned char> block_;
+  unsigned long bit_buffer_;
+  int bit_count_;
+};
+
+// Reads variable width LZW codes back out of GIF data sub-blocks.
+class CodeReader {
+ public:
+  // data points just past the LZW minimum code size byte.
+  CodeReader(const unsigned char* data, std::size_t size)
+      : data_{data}, size_{size}, position_{0}, block_left_{0},
+        bit_buffer_{0}, bit_count_{0} {}
+
+  bool Read(int code_width, int* code) {
+    while (bit_count_ < code_width) {
+      if (block_left_ == 0) {
+        if (position_ >= size_ || data_[position_] == 0) {
+          return false;
+        }
+        block_left_ = data_[position_++];
+      }
+      if (position_ >= size_) {
+        return false;
+      }
+      bit_buffer_ |= static_cast<unsigned long>(data_[position_++])
+                     << bit_count_;
+      bit_count_ += 8;
+      block_left_--;
+    }
+    *code = int(bit_buffer_ & ((1UL << code_width) - 1));
+    bit_buffer_ >>= code_width;
+    bit_count_ -= code_width;
+    return true;
+  }
+
+ private:
+  const unsigned char* data_;
+  std::size_t size_;
+  std::size_t position_;
+  int block_left_;
+  unsigned long bit_buffer_;
+  int bit_count_;
+};
+
+// Write value as a little endian 16-bit number.
+void WriteShort(std::ostream& output, int value) {
+  output.put(char(value & 0xFF));
+  output.put(char((value >> 8) & 0xFF));
+}
+
+}  // namespace
+
+bool ParseGif(const std::vector<unsigned char>& bytes, GifFile* gif) {
+  GifReader reader(bytes);
+  std::vector<unsigned char> signature;
+  if (!reader.ReadBytes(6, &signature) || signature[0] != 'G' ||
+      signature[1] != 'I' || signature[2] != 'F') {
+    return false;
+  }
+  unsigned char packed{0};
+  unsigned char ignored{0};
+  if (!reader.ReadShort(&gif->width) || !reader.ReadShort(&gif->height) ||
+      !reader.ReadByte(&packed) || !reader.ReadByte(&ignored) ||
+      !reader.ReadByte(&ignored)) {
+    return false;
+  }
+  std::vector<unsigned char> global_color_table;
+  if ((packed & 0x80) != 0 &&
+      !reader.ReadBytes(ColorTableBytes(packed), &global_color_table)) {
+    return false;
+  }
+  gif->frames.clear();
+  std::vector<unsigned char> graphic_control;
+  unsigned char introducer{0};
+  while (reader.ReadByte(&introducer)) {
+    if (introducer == kTrailer) {
+      return true;
+    }
+    if (introducer == kExtensionIntroducer) {
+      unsigned char label{0};
+      std::vector<unsigned char> extension;
+      if (!reader.ReadByte(&label) || !reader.ReadSubBlocks(&extension)) {
+        return false;
+      }
+      // A graphic control extension is one sub-block of four bytes that
+      // applies to the next frame. Other extensions, such as comments and
+      // the loop count, are not carried over.
+      if (label == kGraphicControlLabel && extension.size() >= 5 &&
+          extension[0] == 4) {
+        graphic_control.assign(extension.begin() + 1, extension.begin() + 5);
+      }
+    } else if (introducer == kImageSeparator) {
+      GifFrame frame;
+      if (!reader.ReadShort(&frame.left) || !reader.ReadShort(&frame.top) ||
+          !reader.ReadShort(&frame.width) || !reader.ReadShort(&frame.height) ||
+          !reader.ReadByte(&packed)) {
+        return false;
+      }
+      frame.interlaced = (packed & 0x40) != 0;
+      if ((packed & 0x80) != 0) {
+        if (!reader.ReadBytes(ColorTableBytes(packed), &frame.color_table)) {
+          return false;
+        }
+      } else {
+        frame.color_table = global_color_table;
+      }
+      unsigned char minimum_code_size{0};
+      if (!reader.ReadByte(&minimum_code_size)) {
+        return false;
+      }
+      frame.image_data.push_back(minimum_code_size);
+      if (!reader.ReadSubBlocks(&frame.image_data)) {
+        return false;
+      }
+      frame.graphic_control.swap(graphic_control);
+      graphic_control.clear();
+      gif->frames.push_back(std::move(frame));
+    } else {
+      return false;
+    }
+  }
+  // Some writers leave out the trailer; keep whatever frames were complete.
+  return !gif->frames.empty();
+}
+
+GifFrame EncodeIndexedFrame(const unsigned char* indices, int width,
+                            int height,
+                            const std::vector<unsigned char>& color_table) {
+  GifFrame frame;
+  frame.width = width;
+  frame.height = height;
+  frame.color_table = color_table;
+  int minimum_code_size{2};
+  while ((std::size_t(3) << minimum_code_size) < color_table.size()) {
+    minimum_code_size++;
+  }
+  frame.image_data.push_back((unsigned char)minimum_code_size);
+  CodeWriter writer(&frame.image_data);
+
+  const int clear_code = 1 << minimum_code_size;
+  const int end_code = clear_code + 1;
+  int code_width = minimum_code_size + 1;
+  int next_code = clear_code + 2;
+  // An open addressing table from (prefix code, next index) to the code for
+  // the longer string. It never holds more than kMaxLzwCodes entries, so it
+  // stays at most half full.
+  const int kTableSize = 2 * kMaxLzwCodes;
+  std::vector<int> table_keys(kTableSize, -1);
+  std::vector<int> table_codes(kTableSize);
+
+  std::size_t pixel_count = std::size_t(width) * height;
+  writer.Write(clear_code, code_width);
+  if (pixel_count == 0) {
+    writer.Write(end_code, code_width);
+    writer.Finish();
+    return frame;
+  }
+  int prefix = indices[0];
+  for (std::size_t pixel = 1; pixel < pixel_count; pixel++) {
+    int index = indices[pixel];
+    int key = (prefix << 8) | index;
+    int slot = (key * 2654435761U) % kTableSize;
+    while (table_keys[slot] != -1 && table_keys[slot] != key) {
+      slot = (slot + 1) % kTableSize;
+    }
+    if (table_keys[slot] == key) {
+      prefix = table_codes[slot];
+      continue;
+    }
+    writer.Write(prefix, code_width);
+    if (next_code < kMaxLzwCodes) {
+      table_keys[slot] = key;
+      table_codes[slot] = next_code++;
+      if (next_code > (1 << code_width) && code_width < kMaxLzwCodeWidth) {
+        code_width++;
+      }
+    } else {
+      // The table is full; start over.
+      writer.Write(clear_code, code_width);
+      std::fill(table_keys.begin(), table_keys.end(), -1);
+      code_width = minimum_code_size + 1;
+      next_code = clear_code + 2;
+    }
+    prefix = index;
+  }
+  writer.Write(prefix, code_width);
+  // A decoder adds one more string when it reads the last code, which may
+  // widen the codes before the end code.
+  if (next_code == (1 << code_width) && code_width < kMaxLzwCodeWidth) {
+    code_width++;
+  }
+  writer.Write(end_code, code_width);
+  writer.Finish();
+  return frame;
+}
+
+bool DecodeIndexedFrame(const GifFrame& frame,
+                        std::vector<unsigned char>* indices) {
+  indices->clear();
+  if (frame.image_data.empty()) {
+    return false;
+  }
+  int minimum_code_size = frame.image_data[0];
+  if (minimum_code_size < 2 || minimum_code_size > 8) {
+    return false;
+  }
+  CodeReader reader(frame.image_data.data() + 1, frame.image_data.size() - 1);
+  const int clear_code = 1 << minimum_code_size;
+  const int end_code = clear_code + 1;
+  int code_width = minimum_code_size + 1;
+  int next_code = clear_code + 2;
+  // Every code is a previous code followed by one more index.
+  std::vector<int> prefixes(kMaxLzwCodes);
+  std::vector<unsigned char> suffixes(kMaxLzwCodes);
+  std::vector<unsigned char> string;
+  std::size_t pixel_count = std::size_t(frame.width) * frame.height;
+  int previous = -1;
+  int code{0};
+  while (reader.Read(code_width, &code)) {
+    if (code == clear_code) {
+      code_width = minimum_code_size + 1;
+      next_code = clear_code + 2;
+      previous = -1;
+      continue;
+    }
+    if (code == end_code) {
+      break;
+    }
+    if (previous == -1) {
+      if (code >= clear_code) {
+        return false;
+      }
+      indices->push_back((unsigned char)code);
+      previous = code;
+      continue;
+    }
+    if (code > next_code) {
+      return false;
+    }
+    // A code equal to next_code is the previous string followed by its own
+    // first index.
+    int string_code = code < next_code ? code : previous;
+    string.clear();
+    int walk = string_code;
+    for (; walk >= clear_code; walk = prefixes[walk]) {
+      string.push_back(suffixes[walk]);
+    }
+    string.push_back((unsigned char)walk);
+    std::reverse(string.begin(), string.end());
+    if (code == next_code) {
+      string.push_back(string.front());
+    }
+    indices->insert(indices->end(), string.begin(), string.end());
+    if (next_code < kMaxLzwCodes) {
+      prefixes[next_code] = previous;
+      suffixes[next_code] = string.front();
+      next_code++;
+      if (next_code == (1 << code_width) && code_width < kMaxLzwCodeWidth) {
+        code_width++;
+      }
+    }
+    previous = code;
+  }
+  if (indices->size() < pixel_count) {
+    return false;
+  }
+  indices->resize(pixel_count);
+  return true;
+}
+
+GifStreamWriter::GifStreamWriter(std::ostream& output, int width, int height)
+    : output_{output}, width_{width}, height_{height}, wrote_header_{false} {}
+
+void GifStreamWriter::WriteHeader() {
+  output_.write("GIF89a", 6);
+  WriteShort(output_, width_);
+  WriteShort(output_, height_);
+  // No global color table, background color 0, square pixels.
+  output_.put(0);
+  output_.put(0);
+  output_.put(0);
+  // The NETSCAPE2.0 application extension with a loop count of 0 makes the
+  // animation repeat forever.
+  const char kLoopExtension[] = {
+      char(kExtensionIntroducer), char(kApplicationLabel),
+      11, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+      3, 1, 0, 0, 0};
+  output_.write(kLoopExtension, sizeof(kLoopExtension));
+  wrote_header_ = true;
+}
+
+void GifStreamWriter::WriteFrame(const GifFrame& frame) {
+  if (!wrote_header_) {
+    WriteHeader();
+  }
+  output_.put(char(kExtensionIntroducer));
+  output_.put(char(kGraphicControlLabel));
+  output_.put(4);
+  if (frame.graphic_control.size() == 4) {
+    output_.write(reinterpret_cast<const char*>(frame.graphic_control.data()),
+                  4);
+  } else {
+    const char kNoDelay[] = {0, 0, 0, 0};
+    output_.write(kNoDelay, 4);
+  }
+  output_.put(0);
+
+  // Color tables hold a power of two entries, from 2 up to 256.
+  int table_bits{1};
+  while (table_bits < 8 &&
+         (std::size_t(3) << table_bits) < frame.color_table.size()) {
+    table_bits++;
+  }
+  std::size_t table_bytes = std::size_t(3) << table_bits;
+
+  output_.put(char(kImageSeparator));
+  WriteShort(output_, frame.left);
+  WriteShort(output_, frame.top);
+  WriteShort(output_, frame.width);
+  WriteShort(output_, frame.height);
+  output_.put(char(0x80 | (frame.interlaced ? 0x40 : 0) | (table_bits - 1)));
+  output_.write(reinterpret_cast<const char*>(frame.color_table.data()),
+                std::streamsize(
+                    std::min(table_bytes, frame.color_table.size())));
+  for (std::size_t pad = frame.color_table.size(); pad < table_bytes; pad++) {
+    output_.put(0);
+  }
+  output_.write(reinterpret_cast<const char*>(frame.image_data.data()),
+                std::streamsize(frame.image_data.size()));
+}
+
+void GifStreamWriter::Finish() {
+  if (!wrote_header_) {
+    WriteHeader();
+  }
+  output_.put(char(kTrailer));
+  output_.flush();
+}
+
+bool MergeGifs(const std::vector<GifFile>& parts, std::ostream& output,
+               std::string* error_message) {
+  if (parts.empty()) {
+    *error_message = "There are no GIF files to merge.";
+    return false;
+  }
+  for (const GifFile& part : parts) {
+    if (part.width != parts.front().width ||
+        part.height != parts.front().height) {
+      *error_message = "The GIF files to merge are not all the same size.";
+      return false;
+    }
+  }
+  GifStreamWriter gif_writer(output, parts.front().width,
+                             parts.front().height);
+  for (const GifFile& part : parts) {
+    for (const GifFrame& frame : part.frames) {
+      gif_writer.WriteFrame(frame);
+    }
+  }
+  gif_writer.Finish();
+  return true;
+}
@@ -0,0 +1,93 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Reads and writes the blocks of animated GIF files.
+//
+
+#ifndef GIF_STREAM_H
+#define GIF_STREAM_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// One already encoded frame of a GIF file.
+struct GifFrame {
+  /// The four data bytes of the frame's graphic control extension (flags,
+  /// delay and transparent color index), or empty if it has none.
+  std::vector<unsigned char> graphic_control;
+  int left{0};
+  int top{0};
+  int width{0};
+  int height{0};
+  bool interlaced{false};
+  /// The frame's color table as RGB triples; the file's global color table
+  /// if the frame does not have its own.
+  std::vector<unsigned char> color_table;
+  /// The LZW minimum code size followed by the compressed data sub-blocks,
+  /// including the terminating empty sub-block.
+  std::vector<unsigned char> image_data;
+};
+
+/// The logical screen and frames of a GIF file.
+struct GifFile {
+  int width{0};
+  int height{0};
+  std::vector<GifFrame> frames;
+};
+
+/// Split the GIF file in \p bytes into its frames without decoding them.
+/// Returns false if \p bytes is not a well formed GIF file.
+bool ParseGif(const std::vector<unsigned char>& bytes, GifFile* gif);
+
+/// Compress the \p width by \p height palette indices in \p indices, stored
+/// row by row, into a GIF frame that uses \p color_table (RGB triples, at
+/// most 256 colors). No color quantization takes place; every index must be
+/// less than the number of colors in \p color_table.
+GifFrame EncodeIndexedFrame(const unsigned char* indices, int width,
+                            int height,
+                            const std::vector<unsigned char>& color_table);
+
+/// Decompress the palette indices of \p frame into \p indices. Returns
+/// false if the frame's data is not valid LZW data for its size.
+bool DecodeIndexedFrame(const GifFrame& frame,
+                        std::vector<unsigned char>* indices);
+
+/// Writes an endlessly looping animated GIF one encoded frame at a time.
+/// Every frame is written with its own color table, so frames taken from
+/// different files can be mixed freely.
+class GifStreamWriter {
+ public:
+  /// Write a \p width by \p height animation to \p output.
+  GifStreamWriter(std::ostream& output, int width, int height);
+
+  /// Append \p frame to the animation.
+  void WriteFrame(const GifFrame& frame);
+
+  /// Write the end of the file. No frames may be written afterwards.
+  void Finish();
+
+ private:
+  void WriteHeader();
+
+  std::ostream& output_;
+  int width_;
+  int height_;
+  bool wrote_header_;
+};
+
+/// Write the frames of every GIF in \p parts, in order, to \p output as
+/// one endlessly looping animation, without decoding or encoding any frame.
+/// This joins the outputs of an animation rendered in slices back into the
+/// GIF one run would have written. Returns false and sets \p error_message
+/// if there are no parts or their sizes differ.
+bool MergeGifs(const std::vector<GifFile>& parts, std::ostream& output,
+               std::string* error_message);
+
+#endif
@@ -0,0 +1,226 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Hardware performance counters around the setup, rendering and encoding.
+//
+
+#include "perf_counters.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+
+#if defined(LINUX)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#if defined(LINUX)
+// The perf_event_open() type and config of each PerfEvent.
+struct EventCode {
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+const EventCode kEventCodes[kPerfEventCount] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                             (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}};
+
+int OpenEvent(const EventCode& code) {
+  perf_event_attr attributes;
+  std::memset(&attributes, 0, sizeof(attributes));
+  attributes.size = sizeof(attributes);
+  attributes.type = code.type;
+  attributes.config = code.config;
+  attributes.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attributes.inherit = 1;
+  attributes.exclude_kernel = 1;
+  attributes.exclude_hv = 1;
+  // The calling thread, on any CPU, counting from now on.
+  return int(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+#endif
+
+// Print count / divisor with precision decimals, or n/a if either is
+// missing.
+void PrintRatio(std::ostream& output, long long count, double divisor,
+                int precision) {
+  if (count < 0 || divisor <= 0) {
+    output << "n/a";
+    return;
+  }
+  output << std::fixed << std::setprecision(precision) << count / divisor;
+}
+
+void PrintSample(std::ostream& output, const PerfSample& sample,
+                 long long pixels) {
+  output << "cycles ";
+  PrintRatio(output, sample.count(PerfEvent::kCycles), 1e6, 2);
+  output << "M, IPC ";
+  PrintRatio(output, sample.count(PerfEvent::kInstructions),
+             double(sample.count(PerfEvent::kCycles)), 2);
+  output << ", per pixel: L1 misses ";
+  PrintRatio(output, sample.count(PerfEvent::kL1dMisses), double(pixels), 3);
+  output << ", LLC misses ";
+  PrintRatio(output, sample.count(PerfEvent::kLlcMisses), double(pixels), 3);
+  output << ", branch misses ";
+  PrintRatio(output, sample.count(PerfEvent::kBranchMisses), double(pixels),
+             3);
+  output << "\n";
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters() {
+  descriptors_.fill(-1);
+#if defined(LINUX)
+  for (int event = 0; event < kPerfEventCount; event++) {
+    descriptors_[event] = OpenEvent(kEventCodes[event]);
+    if (descriptors_[event] < 0 && error_.empty()) {
+      error_ = std::string("perf_event_open failed: ") + std::strerror(errno);
+    }
+  }
+#else
+  error_ = "perf_event_open is only available on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(LINUX)
+  for (int descriptor : descriptors_) {
+    if (descriptor >= 0) {
+      close(descriptor);
+    }
+  }
+#endif
+}
+
+bool PerfCounters::available() const {
+  for (int descriptor : descriptors_) {
+    if (descriptor >= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+PerfSample PerfCounters::Read() const {
+  PerfSample sample;
+  sample.counts.fill(-1);
+#if defined(LINUX)
+  for (int event = 0; event < kPerfEventCount; event++) {
+    // The count, the time the event was enabled and the time it was
+    // actually on a hardware counter.
+    std::uint64_t values[3];
+    if (descriptors_[event] < 0 ||
+        read(descriptors_[event], values, sizeof(values)) !=
+            ssize_t(sizeof(values)) ||
+        values[2] == 0) {
+      continue;
+    }
+    sample.counts[event] =
+        (long long)(double(values[0]) * double(values[1]) / double(values[2]));
+  }
+#endif
+  return sample;
+}
+
+FrameProfiler::FrameProfiler(long long pixels_per_frame)
+    : pixels_per_frame_{pixels_per_frame} {}
+
+void FrameProfiler::Record(const std::string& phase,
+                           const PerfSample& sample) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& samples : phases_) {
+    if (samples.first == phase) {
+      samples.second.push_back(sample);
+      return;
+    }
+  }
+  phases_.emplace_back(phase, std::vector<PerfSample>{sample});
+}
+
+void FrameProfiler::RecordUnavailable(const std::string& reason) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (unavailable_reason_.empty()) {
+    unavailable_reason_ = reason;
+  }
+}
+
+void FrameProfiler::Report(std::ostream& output) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (phases_.empty()) {
+    output << "Hardware performance counters are not available";
+    if (!unavailable_reason_.empty()) {
+      output << " (" << unavailable_reason_ << ")";
+    }
+    output << "; nothing was profiled.\n";
+    return;
+  }
+  std::ios::fmtflags flags = output.flags();
+  std::streamsize precision = output.precision();
+  for (const auto& samples : phases_) {
+    const std::vector<PerfSample>& phase_samples = samples.second;
+    if (phase_samples.size() == 1) {
+      output << samples.first << ": ";
+      PrintSample(output, phase_samples.front(), pixels_per_frame_);
+      continue;
+    }
+    PerfSample total;
+    total.counts.fill(0);
+    for (std::size_t frame = 0; frame < phase_samples.size(); frame++) {
+      output << samples.first << " image " << frame + 1 << ": ";
+      PrintSample(output, phase_samples[frame], pixels_per_frame_);
+      for (int event = 0; event < kPerfEventCount; event++) {
+        long long count = phase_samples[frame].counts[event];
+        if (total.counts[event] >= 0 && count >= 0) {
+          total.counts[event] += count;
+        } else {
+          total.counts[event] = -1;
+        }
+      }
+    }
+    output << samples.first << " total: ";
+    PrintSample(output, total,
+                pixels_per_frame_ * (long long)phase_samples.size());
+  }
+  output.flags(flags);
+  output.precision(precision);
+}
+
+ProfileScope::ProfileScope(FrameProfiler* profiler, const char* phase)
+    : profiler_{profiler}, phase_{phase} {
+  if (profiler_) {
+    counters_ = std::make_unique<PerfCounters>();
+    if (!counters_->available()) {
+      profiler_->RecordUnavailable(counters_->error());
+      profiler_ = nullptr;
+      counters_.reset();
+    }
+  }
+}
+
+void ProfileScope::Stop() {
+  if (profiler_) {
+    profiler_->Record(phase_, counters_->Read());
+    profiler_ = nullptr;
+    counters_.reset();
+  }
+}
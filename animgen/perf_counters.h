@@ -0,0 +1,121 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Hardware performance counters around the setup, rendering and encoding.
+//
+
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// The hardware events that are counted while profiling.
+enum class PerfEvent {
+  kCycles,
+  kInstructions,
+  /// Level 1 data cache read misses.
+  kL1dMisses,
+  /// Last level cache misses.
+  kLlcMisses,
+  kBranchMisses
+};
+const int kPerfEventCount = 5;
+
+/// How often each PerfEvent happened, indexed by PerfEvent. A count is -1
+/// if that event could not be counted.
+struct PerfSample {
+  std::array<long long, kPerfEventCount> counts;
+
+  long long count(PerfEvent event) const { return counts[int(event)]; }
+};
+
+/// Counts every PerfEvent the CPU and kernel allow with perf_event_open(),
+/// from construction until Read(), on the calling thread and on threads it
+/// starts in the meantime. Only user space is counted, which unprivileged
+/// programs may do under the default perf_event_paranoid setting. Where
+/// perf_event_open() does not exist, or is not allowed, nothing is counted
+/// and available() is false.
+class PerfCounters {
+ public:
+  PerfCounters();
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  /// Check to see if at least one event is being counted.
+  bool available() const;
+
+  /// Why no event is counted, when available() is false.
+  const std::string& error() const { return error_; }
+
+  /// The events counted so far. Counts are scaled up when the kernel had to
+  /// share the hardware counters with other events for part of the time.
+  PerfSample Read() const;
+
+ private:
+  // One file descriptor per PerfEvent, -1 if it could not be opened.
+  std::array<int, kPerfEventCount> descriptors_;
+  std::string error_;
+};
+
+/// Collects PerfSamples of the phases of making an animation, such as
+/// "render" or "encode", and reports them per frame. Samples may be
+/// recorded from any thread.
+class FrameProfiler {
+ public:
+  /// Profile frames of \p pixels_per_frame pixels.
+  explicit FrameProfiler(long long pixels_per_frame);
+
+  /// Add \p sample as the next measurement of \p phase. Each phase is
+  /// measured once per frame, in frame order, apart from setup phases that
+  /// are measured once.
+  void Record(const std::string& phase, const PerfSample& sample);
+
+  /// Note that counters could not be opened, because of \p reason.
+  void RecordUnavailable(const std::string& reason);
+
+  /// Print every measurement to \p output: the cycles, the instructions
+  /// per cycle and the cache and branch misses per pixel.
+  void Report(std::ostream& output) const;
+
+ private:
+  long long pixels_per_frame_;
+  mutable std::mutex mutex_;
+  // The phases in the order they were first recorded.
+  std::vector<std::pair<std::string, std::vector<PerfSample>>> phases_;
+  std::string unavailable_reason_;
+};
+
+/// Counts events from construction until Stop(), or destruction, and
+/// records them with a FrameProfiler as one measurement of a phase. Does
+/// nothing if the profiler is null, so it can be left in place when not
+/// profiling.
+class ProfileScope {
+ public:
+  ProfileScope(FrameProfiler* profiler, const char* phase);
+  ~ProfileScope() { Stop(); }
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+  /// Stop counting and record the measurement. Later calls do nothing.
+  void Stop();
+
+ private:
+  FrameProfiler* profiler_;
+  const char* phase_;
+  std::unique_ptr<PerfCounters> counters_;
+};
+
+#endif
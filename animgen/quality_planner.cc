@@ -0,0 +1,211 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Lowering the quality of an animation to finish it within a deadline.
+//
+
+#include "quality_planner.h"
+
+#include <Magick++.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <utility>
+
+namespace {
+
+// Resolution is lowered this far before any frames are dropped, and this
+// far after.
+const double kFirstMinimumScale = 0.5;
+const double kLastMinimumScale = 0.25;
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+std::string SizeText(int width, int height) {
+  return std::to_string(width) + "x" + std::to_string(height);
+}
+
+class Planner {
+ public:
+  Planner(int width, int height, int frame_count,
+          double fast_quantization_cost, double frame_ms, double budget_ms)
+      : full_width_{width},
+        full_height_{height},
+        fast_quantization_cost_{fast_quantization_cost},
+        frame_ms_{frame_ms},
+        budget_ms_{budget_ms},
+        plan_{width, height, frame_count, false, {}} {}
+
+  QualityPlan& plan() { return plan_; }
+
+  bool Fits() const { return Cost(plan_.frame_count) <= budget_ms_; }
+
+  void UseFastQuantization() {
+    plan_.fast_quantization = true;
+    plan_.degradations.push_back(
+        "faster quantization with more banding and no dithering");
+  }
+
+  // Shrink the frames as little as possible, but no further than
+  // minimum_scale of the full size, to fit the budget.
+  void LowerResolution(double minimum_scale) {
+    double full_frame_ms = Cost(plan_.frame_count) *
+                           double(full_width_) * full_height_ /
+                           (double(plan_.width) * plan_.height);
+    double scale = std::max(0.0, std::sqrt(budget_ms_ / full_frame_ms));
+    scale = std::max(scale, minimum_scale);
+    int width = std::max(1, int(full_width_ * scale));
+    int height = std::max(1, int(full_height_ * scale));
+    if (width >= plan_.width && height >= plan_.height) {
+      return;
+    }
+    plan_.degradations.push_back("resolution lowered from " +
+                                 SizeText(plan_.width, plan_.height) + " to " +
+                                 SizeText(width, height));
+    plan_.width = width;
+    plan_.height = height;
+  }
+
+  void DropFrames() {
+    int frame_count = std::max(1, int(budget_ms_ / Cost(1)));
+    if (frame_count >= plan_.frame_count) {
+      return;
+    }
+    plan_.degradations.push_back("frames cut from " +
+                                 std::to_string(plan_.frame_count) + " to " +
+                                 std::to_string(frame_count));
+    plan_.frame_count = frame_count;
+  }
+
+ private:
+  // The estimated time to make frame_count frames as planned so far.
+  double Cost(int frame_count) const {
+    double pixels = double(plan_.width) * plan_.height /
+                    (double(full_width_) * full_height_);
+    double effort = plan_.fast_quantization ? fast_quantization_cost_ : 1.0;
+    return frame_count * frame_ms_ * pixels * effort;
+  }
+
+  int full_width_;
+  int full_height_;
+  double fast_quantization_cost_;
+  double frame_ms_;
+  double budget_ms_;
+  QualityPlan plan_;
+};
+
+}  // namespace
+
+QualityPlan PlanQuality(int width, int height, int frame_count,
+                        double fast_quantization_cost, double frame_ms,
+                        double budget_ms) {
+  Planner planner(width, height, frame_count, fast_quantization_cost,
+                  frame_ms, budget_ms);
+  if (!planner.Fits() && fast_quantization_cost < 1.0) {
+    planner.UseFastQuantization();
+  }
+  if (!planner.Fits()) {
+    planner.LowerResolution(kFirstMinimumScale);
+  }
+  if (!planner.Fits()) {
+    planner.DropFrames();
+  }
+  if (!planner.Fits()) {
+    planner.LowerResolution(kLastMinimumScale);
+  }
+  if (!planner.Fits()) {
+    planner.plan().degradations.push_back(
+        "the deadline may still be missed at the lowest quality");
+  }
+  return std::move(planner.plan());
+}
+
+QualityPlan PlanForDeadline(
+    int width, int height, int frame_count, PixelFormat format,
+    bool encodes_gif, double budget_ms,
+    const std::function<void(FramePool*, FrameSink*)>& render_frames) {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  FramePool frame_pool(width, height, format);
+  ProbeSink probe(encodes_gif, &frame_pool);
+  render_frames(&frame_pool, &probe);
+  double probe_ms = MillisecondsSince(start);
+  return PlanQuality(width, height, frame_count,
+                     probe.fast_quantization_cost(), probe.frame_ms(),
+                     budget_ms - probe_ms);
+}
+
+ProbeSink::ProbeSink(bool encodes_gif, FramePool* frame_pool)
+    : encodes_gif_{encodes_gif},
+      frame_pool_{frame_pool},
+      start_{std::chrono::steady_clock::now()},
+      measuring_ms_{0.0},
+      quantize_ms_{0.0},
+      fast_quantize_ms_{0.0} {}
+
+void ProbeSink::Consume(FrameBuffer&& frame) {
+  if (encodes_gif_) {
+    Magick::Image image = FrameToImage(frame);
+    frame_pool_->Release(std::move(frame));
+    std::chrono::steady_clock::time_point measuring_start =
+        std::chrono::steady_clock::now();
+    Magick::Image fast_image = image;
+    fast_image.modifyImage();
+    std::chrono::steady_clock::time_point fast_start =
+        std::chrono::steady_clock::now();
+    QuantizeForGif(&fast_image, true);
+    fast_quantize_ms_ = MillisecondsSince(fast_start);
+    measuring_ms_ += MillisecondsSince(measuring_start);
+    std::chrono::steady_clock::time_point quantize_start =
+        std::chrono::steady_clock::now();
+    QuantizeForGif(&image);
+    quantize_ms_ = MillisecondsSince(quantize_start);
+    EncodeGifFrame(&image);
+  } else {
+    frame_pool_->Release(std::move(frame));
+  }
+  FinishFrame();
+}
+
+void ProbeSink::ConsumeIndexed(FrameBuffer&& frame,
+                               const std::vector<unsigned char>& color_table) {
+  if (encodes_gif_) {
+    EncodeIndexedFrame(frame.data(), frame.width(), frame.height(),
+                       color_table);
+  }
+  frame_pool_->Release(std::move(frame));
+  FinishFrame();
+}
+
+double ProbeSink::frame_ms() const {
+  if (frame_ends_ms_.empty()) {
+    return 0.0;
+  }
+  if (frame_ends_ms_.size() == 1) {
+    return frame_ends_ms_.front();
+  }
+  return frame_ends_ms_.back() - frame_ends_ms_[frame_ends_ms_.size() - 2];
+}
+
+double ProbeSink::fast_quantization_cost() const {
+  double frame = frame_ms();
+  if (quantize_ms_ <= 0.0 || frame <= 0.0) {
+    return 1.0;
+  }
+  return std::min(1.0, (frame - quantize_ms_ + fast_quantize_ms_) / frame);
+}
+
+void ProbeSink::FinishFrame() {
+  frame_ends_ms_.push_back(MillisecondsSince(start_) - measuring_ms_);
+}
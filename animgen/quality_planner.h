@@ -0,0 +1,106 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Lowering the quality of an animation to finish it within a deadline.
+//
+
+#ifndef QUALITY_PLANNER_H
+#define QUALITY_PLANNER_H
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "frame_buffer.h"
+#include "frame_pool.h"
+#include "frame_sink.h"
+
+/// The size, length and quantization effort an animation will be rendered
+/// with, and a description of every way that is less than was asked for.
+struct QualityPlan {
+  int width;
+  int height;
+  int frame_count;
+  /// Quantize with FrameSink::UseFastQuantization().
+  bool fast_quantization;
+  std::vector<std::string> degradations;
+};
+
+/// The number of frames PlanForDeadline() has rendered to time one: the
+/// first frame pays for setting up, so only the second is timed.
+const int kProbeFrameCount = 2;
+
+/// Plan a \p width by \p height animation of \p frame_count frames that can
+/// be made in \p budget_ms milliseconds, when one full size frame took
+/// \p frame_ms to render and encode. \p fast_quantization_cost is the share
+/// of \p frame_ms a frame would take with fast quantization; 1 when the
+/// output does not quantize frames, so lowering the effort would not help.
+///
+/// The cost of a frame is taken to grow with its number of pixels. The plan
+/// gives up quality in this order until it fits: quantization effort, then
+/// resolution down to half size, then frames, then resolution down to a
+/// quarter. If even that does not fit, the plan is the smallest it will go
+/// and its last degradation says the deadline may be missed.
+QualityPlan PlanQuality(int width, int height, int frame_count,
+                        double fast_quantization_cost, double frame_ms,
+                        double budget_ms);
+
+/// Time a frame of a \p width by \p height animation of \p frame_count
+/// \p format frames and plan the animation to be made in what is left of
+/// \p budget_ms. \p render_frames must render the first kProbeFrameCount
+/// frames, or all of them if there are fewer, into the pool and sink it is
+/// given. \p encodes_gif tells whether the output is a GIF, so frames are
+/// quantized and encoded as part of their time.
+QualityPlan PlanForDeadline(
+    int width, int height, int frame_count, PixelFormat format,
+    bool encodes_gif, double budget_ms,
+    const std::function<void(FramePool*, FrameSink*)>& render_frames);
+
+/// A FrameSink that does the work of an output without writing anything,
+/// for timing frames: when \p encodes_gif is set, frames are quantized and
+/// encoded like GIF output would do. Frames go back to \p frame_pool.
+///
+/// RGB frames are also quantized a second time with fast quantization, to
+/// measure what it saves; that extra work is left out of frame_ms().
+class ProbeSink : public FrameSink {
+ public:
+  ProbeSink(bool encodes_gif, FramePool* frame_pool);
+  void Consume(FrameBuffer&& frame) override;
+  void ConsumeIndexed(FrameBuffer&& frame,
+                      const std::vector<unsigned char>& color_table) override;
+  void Finish() override {}
+
+  /// The time between the last two frames, so that setting up the renderer
+  /// and allocating frames before the first one are not counted. With only
+  /// one frame, the time from construction until that frame was done; 0
+  /// before any frame.
+  double frame_ms() const;
+
+  /// The share of frame_ms() the last frame would have taken with fast
+  /// quantization, or 1 if no frame was quantized.
+  double fast_quantization_cost() const;
+
+ private:
+  // Note that a frame is done.
+  void FinishFrame();
+
+  bool encodes_gif_;
+  FramePool* frame_pool_;
+  std::chrono::steady_clock::time_point start_;
+  // When each frame was done, in milliseconds since start_, leaving out the
+  // time spent measuring fast quantization.
+  std::vector<double> frame_ends_ms_;
+  double measuring_ms_;
+  // How long the last RGB frame took to quantize each way.
+  double quantize_ms_;
+  double fast_quantize_ms_;
+};
+
+#endif
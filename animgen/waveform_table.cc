@@ -0,0 +1,103 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Lookup tables of periodic waveforms.
+//
+
+#include "waveform_table.h"
+
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+
+namespace {
+
+// The triangle wave at phase, in periods.
+double Triangle(double phase) {
+  double position = phase - std::floor(phase);
+  if (position < 0.25) {
+    return 4.0 * position;
+  }
+  if (position < 0.75) {
+    return 2.0 - 4.0 * position;
+  }
+  return 4.0 * position - 4.0;
+}
+
+// The triangle wave with each half eased in and out by smoothstep.
+double Smoothstep(double phase) {
+  double rise = (Triangle(phase) + 1.0) / 2.0;
+  return 2.0 * rise * rise * (3.0 - 2.0 * rise) - 1.0;
+}
+
+}  // namespace
+
+WaveformTable::WaveformTable(Waveform waveform, int length, double period)
+    : length_{length} {
+  if (length < 1) {
+    throw std::invalid_argument("A waveform table needs at least one entry.");
+  }
+  // Dividing 2 pi by the period rounds the same way as dividing pi by half
+  // of it, so a table with a period of 2 * n matches sin(M_PI / n * i).
+  double radian_step = 2.0 * M_PI / period;
+  samples_.reserve(2 * std::size_t(length) + 1);
+  for (int index = 0; index < length; index++) {
+    switch (waveform) {
+      case Waveform::kSine:
+        samples_.push_back(sin(radian_step * index));
+        break;
+      case Waveform::kCosine:
+        samples_.push_back(cos(radian_step * index));
+        break;
+      case Waveform::kTriangle:
+        samples_.push_back(Triangle(index / period));
+        break;
+      case Waveform::kSmoothstep:
+        samples_.push_back(Smoothstep(index / period));
+        break;
+    }
+  }
+  for (int index = 0; index <= length; index++) {
+    samples_.push_back(samples_[index % length]);
+  }
+}
+
+std::shared_ptr<const WaveformTable> SharedWaveformTable(Waveform waveform,
+                                                         int length,
+                                                         double period) {
+  // The cache only watches the tables; a table is freed once the last
+  // gradient using it is gone, so a long running process does not keep a
+  // table for every size it ever rendered.
+  static std::mutex cache_mutex;
+  static std::map<std::tuple<Waveform, int, double>,
+                  std::weak_ptr<const WaveformTable>>
+      cache;
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  auto key = std::make_tuple(waveform, length, period);
+  auto cached = cache.find(key);
+  if (cached != cache.end()) {
+    if (std::shared_ptr<const WaveformTable> table = cached->second.lock()) {
+      return table;
+    }
+  }
+  // Forget the tables nobody uses any more before adding a new one.
+  for (auto entry = cache.begin(); entry != cache.end();) {
+    if (entry->second.expired()) {
+      entry = cache.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+  auto table = std::make_shared<const WaveformTable>(waveform, length, period);
+  cache[key] = table;
+  return table;
+}
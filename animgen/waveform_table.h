@@ -0,0 +1,81 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// Lookup tables of periodic waveforms.
+//
+
+#ifndef WAVEFORM_TABLE_H
+#define WAVEFORM_TABLE_H
+
+#include <memory>
+#include <vector>
+
+/// The shapes a WaveformTable can hold. Each one rises from 0 to 1 over the
+/// first quarter of a period, falls to -1 at three quarters and returns to 0,
+/// except kCosine, which is kSine a quarter period ahead.
+enum class Waveform { kSine, kCosine, kTriangle, kSmoothstep };
+
+/// A WaveformTable holds a waveform sampled at length() points, entry i
+/// being the waveform i / period of the way through a period.
+///
+/// The table wraps around after length() entries, and it is padded with a
+/// second copy of them, so an entry index that is the sum of two indices
+/// below length() can be looked up without taking a modulo first.
+class WaveformTable {
+ public:
+  /// The number of fraction bits in a fixed point table position.
+  static const int kFractionBits = 16;
+
+  /// Sample \p waveform at \p length points, \p period entries per period.
+  /// Throws std::invalid_argument if \p length is less than 1.
+  WaveformTable(Waveform waveform, int length, double period);
+
+  /// The number of entries before the table wraps around.
+  int length() const { return length_; }
+
+  /// Entry \p index, which must be less than 2 * length().
+  double operator[](int index) const { return samples_[index]; }
+
+  /// The entries, including the padding.
+  const double* data() const { return samples_.data(); }
+
+  /// The table between entries, at fixed point \p position with
+  /// kFractionBits fraction bits, interpolated linearly. \p position must be
+  /// less than 2 * length() entries.
+  double Interpolate(unsigned long long position) const {
+    unsigned long long index = position >> kFractionBits;
+    double fraction = double(position & ((1ULL << kFractionBits) - 1)) /
+                      double(1ULL << kFractionBits);
+    return samples_[index] + (samples_[index + 1] - samples_[index]) * fraction;
+  }
+
+  /// The fixed point step between positions that walks the whole table in
+  /// \p output_length equal steps, for reading the table at a length that is
+  /// different from its own.
+  unsigned long long FixedPointStep(int output_length) const {
+    return (static_cast<unsigned long long>(length_) << kFractionBits) /
+           output_length;
+  }
+
+ private:
+  int length_;
+  // 2 * length_ + 1 entries, so Interpolate() can always read one past the
+  // entry it starts from.
+  std::vector<double> samples_;
+};
+
+/// Return the table for \p waveform, \p length and \p period that is shared
+/// by the whole process, building it the first time it is asked for. A table
+/// is only kept while someone holds it, and built again if it is asked for
+/// after that. Safe to call from any thread.
+std::shared_ptr<const WaveformTable> SharedWaveformTable(Waveform waveform,
+                                                         int length,
+                                                         double period);
+
+#endif
@@ -0,0 +1,118 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// A thread pool whose idle workers steal queued tasks from busy ones.
+//
+
+#include "work_stealing_pool.h"
+
+#include <utility>
+
+namespace {
+
+// The index of the pool worker running on this thread, or -1 on any other
+// thread.
+thread_local int current_worker_index = -1;
+thread_local const void* current_pool = nullptr;
+
+}  // namespace
+
+WorkStealingPool::WorkStealingPool(int thread_count) {
+  for (int worker = 0; worker < thread_count; worker++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (int worker = 0; worker < thread_count; worker++) {
+    threads_.emplace_back(&WorkStealingPool::Run, this, worker);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  Wait();
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  work_available_.notify_all();
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::Submit(std::function<void()> task) {
+  int worker_index = current_worker_index;
+  if (current_pool != this) {
+    worker_index = next_worker_++ % int(workers_.size());
+  }
+  pending_tasks_++;
+  {
+    std::lock_guard<std::mutex> lock(workers_[worker_index]->mutex);
+    workers_[worker_index]->tasks.push_back(std::move(task));
+  }
+  queued_tasks_++;
+  std::lock_guard<std::mutex> lock(sleep_mutex_);
+  work_available_.notify_one();
+}
+
+void WorkStealingPool::Wait() {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  all_done_.wait(lock, [this] { return pending_tasks_ == 0; });
+}
+
+bool WorkStealingPool::PopOwn(int worker_index, std::function<void()>* task) {
+  Worker& worker = *workers_[worker_index];
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  if (worker.tasks.empty()) {
+    return false;
+  }
+  *task = std::move(worker.tasks.back());
+  worker.tasks.pop_back();
+  queued_tasks_--;
+  return true;
+}
+
+bool WorkStealingPool::Steal(int worker_index, std::function<void()>* task) {
+  int worker_count = int(workers_.size());
+  for (int offset = 1; offset < worker_count; offset++) {
+    Worker& victim = *workers_[(worker_index + offset) % worker_count];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      queued_tasks_--;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::Run(int worker_index) {
+  current_worker_index = worker_index;
+  current_pool = this;
+  std::function<void()> task;
+  while (true) {
+    if (PopOwn(worker_index, &task) || Steal(worker_index, &task)) {
+      task();
+      task = nullptr;
+      if (--pending_tasks_ == 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        all_done_.notify_all();
+      }
+      continue;
+    }
+    // Every queue looked empty. Submit() counts a task as queued before it
+    // takes sleep_mutex_ to notify, so checking the count under the same lock
+    // cannot miss a task that arrived after the queues were searched.
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    work_available_.wait(lock,
+                         [this] { return stopping_ || queued_tasks_ > 0; });
+    if (stopping_ && queued_tasks_ == 0) {
+      return;
+    }
+  }
+}
@@ -0,0 +1,68 @@
+// Wilfredo Rodas
+// CPSC 120-01
+// 2022-12-05
+// rodaswilfredo24@csu.fullerton.edu
+// @rodasw24
+//
+// Lab 12
+// Partners: @AHan003, @alton7759
+//
+// A thread pool whose idle workers steal queued tasks from busy ones.
+//
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Runs tasks on a fixed set of worker threads. Every worker has its own
+/// queue of tasks. A worker takes its newest task first, which keeps the data
+/// a task just produced hot in its cache, and when its queue runs dry it
+/// steals the oldest task from another worker. Tasks may submit more tasks.
+class WorkStealingPool {
+ public:
+  /// Start \p thread_count worker threads.
+  explicit WorkStealingPool(int thread_count);
+
+  /// Wait for every task to finish and stop the workers.
+  ~WorkStealingPool();
+
+  /// Queue \p task. A task submitted from a worker goes on that worker's own
+  /// queue; other tasks are spread across the workers.
+  void Submit(std::function<void()> task);
+
+  /// Wait until every submitted task, including tasks submitted by tasks,
+  /// has finished.
+  void Wait();
+
+ private:
+  struct Worker {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void Run(int worker_index);
+  bool PopOwn(int worker_index, std::function<void()>* task);
+  bool Steal(int worker_index, std::function<void()>* task);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::atomic<int> next_worker_{0};
+  // Tasks that have been submitted but have not finished.
+  std::atomic<long> pending_tasks_{0};
+  // Tasks that are waiting in a queue.
+  std::atomic<long> queued_tasks_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable work_available_;
+  std::condition_variable all_done_;
+  bool stopping_{false};
+};
+
+#endif
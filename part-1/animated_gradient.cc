@@ -11,13 +11,22 @@
 //
 #include <Magick++.h>
 
-#include <cmath>
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "animated_gradient_functions.h"
+#include "command_line.h"
+#include "frame_digest.h"
+#include "frame_pool.h"
+#include "frame_pyramid.h"
+#include "frame_renderer.h"
+#include "frame_sink.h"
+#include "frame_stream.h"
+#include "perf_counters.h"
+#include "quality_planner.h"
 
 // The width of the image is the number of columns.
 const int kImageWidth{512};
@@ -25,13 +34,16 @@ const int kImageWidth{512};
 const int kImageHeight{512};
 // The number of images in our flipbook animation.
 const int kNumberOfImages = 10;
+// The frame rate recorded in Y4M output.
+const int kFramesPerSecond = 10;
 
 int main(int argc, char* argv[]) {
   // Initialize the GraphicsMagick library. It must be the first thing
   // that happens in the main function.
   // Do not change or remove the line below.
   Magick::InitializeMagick(*argv);
-  std::vector<std::string> args{argv, argv + argc};
+  CommandLine command_line = ParseCommandLine({argv, argv + argc});
+  const std::vector<std::string>& args = command_line.arguments;
   // convert the command line arguments to a
   // std::vector of std::strings.
   if (args.size() < 2) {
@@ -39,39 +51,117 @@ int main(int argc, char* argv[]) {
     return 1;
   }
   std::string output_file_name{args.at(1)};
+  OutputFormat output_format{OutputFormat::kGif};
+  if (!ParseOutputFormat(OptionValue(command_line, "format", "gif"),
+                         &output_format)) {
+    std::cout << "The output format must be gif, rgb or y4m.\n";
+    return 1;
+  }
   std::string image_format{".gif"};
-  if (!HasMatchingFileExtension(output_file_name, image_format)) {
+  if (output_format == OutputFormat::kGif &&
+      !HasMatchingFileExtension(output_file_name, image_format)) {
     std::cout << output_file_name
               << " is missing the required file extension .gif.\n";
     return 1;
   }
-  std::vector<double> sine_lookup_table = BuildSineLookupTable(kImageWidth);
-  Magick::ColorRGB white(1, 1, 1);
-  std::vector<Magick::Image> images;
-  double bule_step = M_PI / double(kNumberOfImages);
-  int row_col_step = kImageWidth / kNumberOfImages;
-  for (int current_image = 0; current_image < kNumberOfImages;
-       current_image++) {
-    Magick::Image image =
-        Magick::Image(Magick::Geometry(kImageWidth, kImageHeight), white);
-    std::cerr << "Image " << current_image + 1 << "...";
-    double blue = sin(bule_step * current_image);
-
-    for (int column = 0; column < image.columns(); column++) {
-      for (int row = 0; row < image.rows(); row++) {
-        int current_step = current_image * row_col_step;
-        double red =
-            sine_lookup_table.at((column + current_step) % kImageWidth);
-        double green =
-            sine_lookup_table.at((row + current_step) % kImageHeight);
-        Magick::ColorRGB color(red, green, blue);
-        image.pixelColor(column, row, color);
-      }
+  int thread_count{0};
+  if (!IntegerOptionValue(command_line, "threads", DefaultThreadCount(),
+                          &thread_count) ||
+      thread_count < 1) {
+    std::cout << "The number of threads must be a positive integer.\n";
+    return 1;
+  }
+  const int max_size_count = MaxPyramidLevels(kImageWidth, kImageHeight);
+  int size_count{0};
+  if (!IntegerOptionValue(command_line, "sizes", 1, &size_count) ||
+      size_count < 1 || size_count > max_size_count) {
+    std::cout << "The number of sizes must be between 1 and "
+              << max_size_count << ".\n";
+    return 1;
+  }
+  const bool digest = HasOption(command_line, "digest");
+  if (digest && size_count > 1) {
+    std::cout << "--sizes cannot be combined with --digest.\n";
+    return 1;
+  }
+  int deadline_ms{0};
+  if (!IntegerOptionValue(command_line, "deadline-ms", 0, &deadline_ms) ||
+      (HasOption(command_line, "deadline-ms") && deadline_ms < 1)) {
+    std::cout << "The deadline must be a positive number of milliseconds.\n";
+    return 1;
+  }
+  int first_frame{0};
+  int end_frame{0};
+  if (!FrameRangeOptionValue(command_line, "frames", kNumberOfImages,
+                             &first_frame, &end_frame)) {
+    std::cout << "The frames must be START-END, from 0 to "
+              << kNumberOfImages - 1 << ".\n";
+    return 1;
+  }
+  if (HasOption(command_line, "frames") && deadline_ms > 0) {
+    // A deadline could give each slice a different size or length.
+    std::cout << "--frames cannot be combined with --deadline-ms.\n";
+    return 1;
+  }
+  // Keep standard output clean when frames or digests are written to it.
+  std::ostream& info_stream =
+      digest || WritesToStandardOutput(output_format, output_file_name)
+          ? std::cerr
+          : std::cout;
+  GradientParams params{kImageWidth, kImageHeight, kNumberOfImages};
+  params.first_frame = first_frame;
+  params.end_frame = end_frame;
+  QualityPlan plan{kImageWidth, kImageHeight, kNumberOfImages, false, {}};
+  if (deadline_ms > 0) {
+    plan = PlanForDeadline(
+        kImageWidth, kImageHeight, kNumberOfImages, PixelFormat::kRgb8,
+        output_format == OutputFormat::kGif, deadline_ms,
+        [&](FramePool* probe_pool, FrameSink* probe) {
+          GradientParams probe_params{kImageWidth, kImageHeight,
+                                      kNumberOfImages};
+          probe_params.end_frame = std::min(kProbeFrameCount, kNumberOfImages);
+          RenderGradient(probe_params, thread_count, false, probe_pool, probe);
+        });
+    params = GradientParams{plan.width, plan.height, plan.frame_count};
+    int planned_size_count = MaxPyramidLevels(plan.width, plan.height);
+    if (size_count > planned_size_count) {
+      plan.degradations.push_back("sizes cut from " +
+                                  std::to_string(size_count) + " to " +
+                                  std::to_string(planned_size_count));
+      size_count = planned_size_count;
+    }
+    for (const std::string& degradation : plan.degradations) {
+      info_stream << "To finish within " << deadline_ms
+                  << " ms: " << degradation << ".\n";
     }
-    images.push_back(image);
-    std::cerr << "completed.\n";
   }
-  Magick::writeImages(images.begin(), images.end(), output_file_name);
+  FramePool frame_pool(params.image_width, params.image_height);
+  std::string error_message;
+  std::unique_ptr<FrameSink> sink;
+  if (digest) {
+    sink = std::make_unique<DigestSink>(std::cout, params.first_frame,
+                                        &frame_pool);
+  } else {
+    sink = OpenPyramidSink(output_format, output_file_name, params.image_width,
+                           params.image_height, kFramesPerSecond, size_count,
+                           &frame_pool, &error_message);
+  }
+  if (!sink) {
+    std::cout << error_message << "\n";
+    return 1;
+  }
+  if (plan.fast_quantization) {
+    sink->UseFastQuantization();
+  }
+  FrameProfiler profiler((long long)params.image_width * params.image_height);
+  if (HasOption(command_line, "profile")) {
+    params.profiler = &profiler;
+    sink->UseProfiler(&profiler);
+  }
+  RenderGradient(params, thread_count, true, &frame_pool, sink.get());
+  if (params.profiler) {
+    profiler.Report(info_stream);
+  }
   // Check to make sure you have enough arguments. If you have
   // too few, print an error message and exit.
   // Declare a std::string variable named output_file_name.
@@ -14,12 +14,14 @@
 
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+
+#include "command_line.h"
+#include "frame_renderer.h"
 
 bool HasMatchingFileExtension(const std::string& file_name,
                               const std::string& extension) {
-  return file_name.size() >= extension.size() &&
-         (file_name.compare(file_name.size() - extension.size(),
-                            extension.size(), extension) == 0);
+  return HasFileExtension(file_name, extension);
 }
 
 std::vector<double> BuildSineLookupTable(int image_width) {
@@ -32,3 +34,48 @@ std::vector<double> BuildSineLookupTable(int image_width) {
 
   return lookup_table;
 }
+
+GradientShader::GradientShader(int image_width, int image_height,
+                               int number_of_images)
+    : column_wave_{SharedWaveformTable(Waveform::kSine, image_width,
+                                       2.0 * image_width)},
+      row_wave_{SharedWaveformTable(Waveform::kSine, image_height,
+                                    2.0 * image_width)} {
+  double blue_step = M_PI / double(number_of_images);
+  int row_col_step = image_width / number_of_images;
+  for (int image = 0; image < number_of_images; image++) {
+    frame_column_steps_.push_back(image * row_col_step % image_width);
+    frame_row_steps_.push_back(image * row_col_step % image_height);
+    frame_blues_.push_back(sin(blue_step * image));
+  }
+}
+
+void RenderGradient(const GradientParams& params, int thread_count,
+                    bool report_progress, FramePool* frame_pool,
+                    FrameSink* sink) {
+  ProfileScope setup(params.profiler, "setup");
+  GradientShader shader(params.image_width, params.image_height,
+                        params.number_of_images);
+  setup.Stop();
+  AnimationSpec spec{params.image_width, params.image_height,
+                     params.number_of_images, thread_count, report_progress,
+                     params.first_frame, params.end_frame, params.profiler};
+  RenderAnimation(spec, shader, frame_pool, sink);
+}
+
+FrameBuffer RenderFrame(const GradientParams& params, int frame,
+                        int thread_count) {
+  if (frame < 0 || frame >= params.number_of_images) {
+    throw std::out_of_range("The frame to render is out of range.");
+  }
+  GradientShader shader(params.image_width, params.image_height,
+                        params.number_of_images);
+  FrameBuffer image(params.image_width, params.image_height,
+                    PixelFormat::kRgb8);
+  ShadeFrame(shader, frame, thread_count, &image);
+  return image;
+}
+
+FrameBuffer RenderFrame(const GradientParams& params, int frame) {
+  return RenderFrame(params, frame, DefaultThreadCount());
+}
@@ -17,12 +17,87 @@
 #ifndef ANIMAGED_GRADIENT_FUNCTIONS_H
 #define ANIMAGED_GRADIENT_FUNCTIONS_H
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "frame_buffer.h"
+#include "frame_pool.h"
+#include "frame_shader.h"
+#include "frame_sink.h"
+#include "perf_counters.h"
+#include "waveform_table.h"
+
 bool HasMatchingFileExtension(const std::string& file_name,
                               const std::string& extension);
 
 std::vector<double> BuildSineLookupTable(int image_width);
 
+/// Shades the animated gradient. Red follows the columns and green follows
+/// the rows of a sine wave that scrolls a little further every frame; blue
+/// is the same for every pixel of a frame. The waves are read from padded
+/// lookup tables shared by every gradient of the same size, so shading a
+/// pixel takes neither sin() nor a modulo.
+class GradientShader {
+ public:
+  static constexpr bool kIndependentPixels = true;
+
+  /// Prepare a gradient for \p number_of_images frames that are
+  /// \p image_width by \p image_height pixels.
+  GradientShader(int image_width, int image_height, int number_of_images);
+
+  void BeginFrame(int frame) {}
+
+  /// The color of one pixel of frame \p frame, which must be one of the
+  /// number_of_images frames; it is not checked here.
+  PixelColor operator()(int column, int row, int frame) const {
+    return PixelColor{(*column_wave_)[column + frame_column_steps_[frame]],
+                      (*row_wave_)[row + frame_row_steps_[frame]],
+                      frame_blues_[frame]};
+  }
+
+ private:
+  // Half a period of sine across the width of the image, wrapping after
+  // the last column and after the last row.
+  std::shared_ptr<const WaveformTable> column_wave_;
+  std::shared_ptr<const WaveformTable> row_wave_;
+  // How far the waves have scrolled in each frame, less than one wrap.
+  std::vector<int> frame_column_steps_;
+  std::vector<int> frame_row_steps_;
+  // The blue channel of each frame.
+  std::vector<double> frame_blues_;
+};
+
+/// The size and length of an animated gradient.
+struct GradientParams {
+  int image_width;
+  int image_height;
+  int number_of_images;
+  /// Render only frames first_frame up to but not including end_frame; an
+  /// end_frame of -1 stands for number_of_images.
+  int first_frame = 0;
+  int end_frame = -1;
+  /// Measures building the lookup tables, as the "setup" phase, and
+  /// rendering each frame when not null.
+  FrameProfiler* profiler = nullptr;
+};
+
+/// Render every frame of the animated gradient described by \p params with
+/// up to \p thread_count threads and hand them to \p sink. Frames come from
+/// \p frame_pool, which must hold RGB8 frames of the gradient's size.
+/// Progress is reported on standard error if \p report_progress is set.
+void RenderGradient(const GradientParams& params, int thread_count,
+                    bool report_progress, FramePool* frame_pool,
+                    FrameSink* sink);
+
+/// Render only frame number \p frame of the animated gradient described by
+/// \p params as RGB8, using \p thread_count threads. Throws
+/// std::out_of_range if \p frame is not one of the animation's frames.
+FrameBuffer RenderFrame(const GradientParams& params, int frame,
+                        int thread_count);
+
+/// Render only frame number \p frame of the animated gradient described by
+/// \p params as RGB8 as quickly as possible.
+FrameBuffer RenderFrame(const GradientParams& params, int frame);
+
 #endif
@@ -16,10 +16,17 @@
 #include <gtest/gtest.h>
 #include <limits.h>
 
+#include <cmath>
 #include <cstdio>
+#include <fstream>
 #include <future>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
 #include "animated_gradient_functions.h"
+#include "frame_digest.h"
+#include "frame_renderer.h"
 
 // Thanks to Paul Inventado
 // https://github.com/google/googletest/issues/348#issuecomment-431714269
@@ -610,4 +617,88 @@ TEST(BuildSineLookupTable, Values) {
   }
 }
 
+TEST(GradientShader, ScrollsWithEachFrame) {
+  std::vector<double> lut = BuildSineLookupTable(512);
+  GradientShader shader(512, 512, 10);
+  PixelColor first = shader(0, 0, 0);
+  EXPECT_DOUBLE_EQ(lut.at(0), first.red);
+  EXPECT_DOUBLE_EQ(lut.at(0), first.green);
+  EXPECT_DOUBLE_EQ(0.0, first.blue);
+  // Every frame scrolls the table by 512 / 10 = 51 entries.
+  PixelColor scrolled = shader(500, 3, 2);
+  EXPECT_DOUBLE_EQ(lut.at((500 + 102) % 512), scrolled.red);
+  EXPECT_DOUBLE_EQ(lut.at(3 + 102), scrolled.green);
+  EXPECT_DOUBLE_EQ(sin(M_PI / 10.0 * 2), scrolled.blue);
+}
+
+TEST(RenderFrame, ShadesEveryPixel) {
+  GradientParams params{64, 48, 4};
+  GradientShader shader(64, 48, 4);
+  for (int thread_count : {1, 3}) {
+    FrameBuffer image = RenderFrame(params, 2, thread_count);
+    ASSERT_EQ(PixelFormat::kRgb8, image.format());
+    for (int row = 0; row < 48; row++) {
+      for (int column = 0; column < 64; column++) {
+        PixelColor color = shader(column, row, 2);
+        const unsigned char* pixel = image.row(row) + 3 * column;
+        ASSERT_EQ(ChannelToByte(color.red), pixel[0]);
+        ASSERT_EQ(ChannelToByte(color.green), pixel[1]);
+        ASSERT_EQ(ChannelToByte(color.blue), pixel[2]);
+      }
+    }
+  }
+}
+
+TEST(GradientShader, MatchesLookupTableOnWideImages) {
+  std::vector<double> lut = BuildSineLookupTable(640);
+  GradientShader shader(640, 480, 10);
+  for (int frame = 0; frame < 10; frame++) {
+    int step = frame * (640 / 10);
+    for (int row = 0; row < 480; row += 7) {
+      for (int column = 0; column < 640; column += 5) {
+        PixelColor color = shader(column, row, frame);
+        ASSERT_EQ(lut.at((column + step) % 640), color.red);
+        ASSERT_EQ(lut.at((row + step) % 480), color.green);
+      }
+    }
+  }
+}
+
+TEST(RenderGradient, MatchesGoldenDigests) {
+  std::ifstream golden_file("sample_images/sample_image.digest");
+  ASSERT_TRUE(golden_file.is_open());
+  std::ostringstream golden;
+  golden << golden_file.rdbuf();
+  FramePool frame_pool(512, 512);
+  std::ostringstream digests;
+  DigestSink sink(digests, 0, &frame_pool);
+  RenderGradient(GradientParams{512, 512, 10}, 2, false, &frame_pool, &sink);
+  EXPECT_EQ(golden.str(), digests.str());
+}
+
+TEST(RenderFrame, MatchesFullRun) {
+  GradientParams params{40, 70, 6};
+  FramePool frame_pool(40, 70);
+  std::ostringstream digests;
+  DigestSink sink(digests, 0, &frame_pool);
+  RenderGradient(params, 2, false, &frame_pool, &sink);
+  std::istringstream lines(digests.str());
+  std::string line;
+  for (int frame = 0; frame < 6; frame++) {
+    ASSERT_TRUE(std::getline(lines, line));
+    FrameBuffer image = RenderFrame(params, frame);
+    EXPECT_EQ("frame " + std::to_string(frame) + " " +
+                  DigestText(DigestBytes(image.data(), image.size_bytes())),
+              line);
+  }
+}
+
+TEST(RenderFrame, RejectsFramesOutOfRange) {
+  GradientParams params{40, 30, 6};
+  EXPECT_THROW(RenderFrame(params, -1), std::out_of_range);
+  EXPECT_THROW(RenderFrame(params, 6), std::out_of_range);
+  EXPECT_THROW(RenderFrame(params, 6, 3), std::out_of_range);
+  EXPECT_NO_THROW(RenderFrame(params, 5));
+}
+
 }  // namespace
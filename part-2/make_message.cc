@@ -13,21 +13,39 @@
 #include <Magick++.h>
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "command_line.h"
+#include "frame_digest.h"
+#include "frame_pool.h"
+#include "frame_pyramid.h"
+#include "frame_renderer.h"
+#include "frame_sink.h"
+#include "frame_stream.h"
 #include "make_message_functions.h"
+#include "perf_counters.h"
+#include "quality_planner.h"
 
 int main(int argc, char const* argv[]) {
   Magick::InitializeMagick(*argv);
-  std::vector<std::string> args{argv, argv + argc};
+  CommandLine command_line = ParseCommandLine({argv, argv + argc});
+  const std::vector<std::string>& args = command_line.arguments;
   if (args.size() < 2) {
     std::cout << "Please provide a path to a file.\n";
     return 1;
   }
   std::string output_file_name{args.at(1)};
+  OutputFormat output_format{OutputFormat::kGif};
+  if (!ParseOutputFormat(OptionValue(command_line, "format", "gif"),
+                         &output_format)) {
+    std::cout << "The output format must be gif, rgb or y4m.\n";
+    return 1;
+  }
   std::string image_format{".gif"};
-  if (!HasMatchingFileExtension(output_file_name, image_format)) {
+  if (output_format == OutputFormat::kGif &&
+      !HasMatchingFileExtension(output_file_name, image_format)) {
     std::cout << output_file_name
               << " is missing the required file extension .gif.\n";
     return 1;
@@ -36,46 +54,121 @@ int main(int argc, char const* argv[]) {
   const double aspect_ratio = 16.0 / 9.0;
   const int image_width = 1024;
   const int image_height = int(lround(image_width / aspect_ratio));
-  Magick::ColorRGB yellow(1, 1, 0);
-  Magick::Image image(Magick::Geometry(image_width, image_height), yellow);
-  std::cout << "Your image has " << image.columns()
-            << " columns (x direction) and " << image.rows()
-            << " rows (y direction).\n";
-
   const int number_of_images = 5;
-  std::vector<Magick::Image> images;
-  for (int image_count = 0; image_count < number_of_images; image_count++) {
-    std::cerr << "Image " << image_count + 1 << "...";
-    for (int row = 0; row < image.rows(); row++) {
-      for (int column = 0; column < image.columns(); column++) {
-        double random_color_intensity = RandomDouble01();
-        double red = 0.0;
-        double green = 0.0;
-        double blue = 0.0;
-        if (CoinFlip()) {
-          red = random_color_intensity;
-        }
-        if (CoinFlip()) {
-          green = random_color_intensity;
-        }
-        if (CoinFlip()) {
-          blue = random_color_intensity;
-        }
-        Magick::ColorRGB color(red, green, blue);
-        image.pixelColor(column, row, color);
-        Magick::ColorRGB colortwo(red, green, blue);
-        image.pixelColor(column, row, colortwo);
-      }
+  const int frames_per_second = 10;
+  int thread_count{0};
+  if (!IntegerOptionValue(command_line, "threads", DefaultThreadCount(),
+                          &thread_count) ||
+      thread_count < 1) {
+    std::cout << "The number of threads must be a positive integer.\n";
+    return 1;
+  }
+  const int max_size_count = MaxPyramidLevels(image_width, image_height);
+  int size_count{0};
+  if (!IntegerOptionValue(command_line, "sizes", 1, &size_count) ||
+      size_count < 1 || size_count > max_size_count) {
+    std::cout << "The number of sizes must be between 1 and "
+              << max_size_count << ".\n";
+    return 1;
+  }
+  const bool digest = HasOption(command_line, "digest");
+  if (digest && size_count > 1) {
+    std::cout << "--sizes cannot be combined with --digest.\n";
+    return 1;
+  }
+  std::string noise{OptionValue(command_line, "noise", "shaded")};
+  if (noise != "shaded" && noise != "indexed" && noise != "tiles") {
+    std::cout << "The noise must be shaded, indexed or tiles.\n";
+    return 1;
+  }
+  int tile_randomness{0};
+  if (!IntegerOptionValue(command_line, "tile-randomness", 3,
+                          &tile_randomness) ||
+      tile_randomness < kMinTileRandomness ||
+      tile_randomness > kMaxTileRandomness) {
+    std::cout << "The tile randomness must be between " << kMinTileRandomness
+              << " and " << kMaxTileRandomness << ".\n";
+    return 1;
+  }
+  int deadline_ms{0};
+  if (!IntegerOptionValue(command_line, "deadline-ms", 0, &deadline_ms) ||
+      (HasOption(command_line, "deadline-ms") && deadline_ms < 1)) {
+    std::cout << "The deadline must be a positive number of milliseconds.\n";
+    return 1;
+  }
+  int first_frame{0};
+  int end_frame{0};
+  if (!FrameRangeOptionValue(command_line, "frames", number_of_images,
+                             &first_frame, &end_frame)) {
+    std::cout << "The frames must be START-END, from 0 to "
+              << number_of_images - 1 << ".\n";
+    return 1;
+  }
+  if (HasOption(command_line, "frames") && deadline_ms > 0) {
+    // A deadline could give each slice a different size or length.
+    std::cout << "--frames cannot be combined with --deadline-ms.\n";
+    return 1;
+  }
+  MessageParams params{image_width, image_height, number_of_images, message};
+  params.noise = noise == "indexed" ? MessageNoise::kIndexed
+                 : noise == "tiles" ? MessageNoise::kTiles
+                                    : MessageNoise::kShaded;
+  params.tile_randomness = tile_randomness;
+  params.first_frame = first_frame;
+  params.end_frame = end_frame;
+  // Keep standard output clean when frames or digests are written to it.
+  std::ostream& info_stream =
+      digest || WritesToStandardOutput(output_format, output_file_name)
+          ? std::cerr
+          : std::cout;
+  QualityPlan plan{image_width, image_height, number_of_images, false, {}};
+  if (deadline_ms > 0) {
+    plan = PlanMessageForDeadline(deadline_ms,
+                                  output_format == OutputFormat::kGif,
+                                  thread_count, &params);
+    int planned_size_count = MaxPyramidLevels(plan.width, plan.height);
+    if (size_count > planned_size_count) {
+      plan.degradations.push_back("sizes cut from " +
+                                  std::to_string(size_count) + " to " +
+                                  std::to_string(planned_size_count));
+      size_count = planned_size_count;
+    }
+    for (const std::string& degradation : plan.degradations) {
+      info_stream << "To finish within " << deadline_ms
+                  << " ms: " << degradation << ".\n";
     }
-    image.font("Helvetica");
-    image.fontPointsize(image.rows() / 3.0);
-    image.fillColor(Magick::Color("yellow"));
-    image.annotate(message, Magick::CenterGravity);
-
-    images.push_back(image);
-    std::cerr << "completed.\n";
   }
-  Magick::writeImages(images.begin(), images.end(), output_file_name);
+  FramePool frame_pool(params.image_width, params.image_height,
+                       MessagePixelFormat(params));
+  std::string error_message;
+  std::unique_ptr<FrameSink> sink;
+  if (digest) {
+    sink = std::make_unique<DigestSink>(std::cout, params.first_frame,
+                                        &frame_pool);
+  } else {
+    sink = OpenPyramidSink(output_format, output_file_name, params.image_width,
+                           params.image_height, frames_per_second, size_count,
+                           &frame_pool, &error_message);
+  }
+  if (!sink) {
+    std::cout << error_message << "\n";
+    return 1;
+  }
+  if (plan.fast_quantization) {
+    sink->UseFastQuantization();
+  }
+  info_stream << "Your image has " << frame_pool.columns()
+              << " columns (x direction) and " << frame_pool.rows()
+              << " rows (y direction).\n";
 
+  FrameProfiler profiler((long long)params.image_width * params.image_height);
+  if (HasOption(command_line, "profile")) {
+    params.profiler = &profiler;
+    sink->UseProfiler(&profiler);
+  }
+  RenderMessage(params, thread_count, true, &frame_pool, sink.get());
+  if (params.profiler) {
+    profiler.Report(info_stream);
+  }
   return 0;
 }
@@ -12,14 +12,18 @@
 
 #include "make_message_functions.h"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <iomanip>
+#include <stdexcept>
+
+#include "command_line.h"
+#include "frame_renderer.h"
 
 bool HasMatchingFileExtension(const std::string& file_name,
                               const std::string& extension) {
-  return file_name.size() >= extension.size() &&
-         (file_name.compare(file_name.size() - extension.size(),
-                            extension.size(), extension) == 0);
-  return false;
+  return HasFileExtension(file_name, extension);
 }
 
 std::seed_seq rng_seed{1, 2, 3, 4, 5};
@@ -38,3 +42,346 @@ double RandomDouble01() {
 double RandomDouble11() { return rng_11.next(); }
 
 bool CoinFlip() { return rng_coin_flip.next() > 0.0; }
+
+// Each draw from a uniform_real_distribution<double> takes two values from a
+// 32-bit std::mt19937, as required for the 53 bits of a double.
+const unsigned long long kEngineCallsPerDraw = 2;
+// Every pixel draws one intensity and flips three coins.
+const unsigned long long kIntensityDrawsPerPixel = 1;
+const unsigned long long kCoinFlipsPerPixel = 3;
+
+NoiseShader::NoiseShader(int image_width, int image_height)
+    : pixels_per_frame_{static_cast<unsigned long long>(image_width) *
+                        image_height},
+      next_frame_{0},
+      intensity_dist_{0, 1},
+      coin_flip_dist_{-1, 1} {
+  std::seed_seq seed{1, 2, 3, 4, 5};
+  intensity_engine_.seed(seed);
+  coin_flip_engine_.seed(seed);
+}
+
+void NoiseShader::BeginFrame(int frame) {
+  if (frame == next_frame_) {
+    next_frame_ = frame + 1;
+    return;
+  }
+  if (frame < next_frame_) {
+    std::seed_seq seed{1, 2, 3, 4, 5};
+    intensity_engine_.seed(seed);
+    coin_flip_engine_.seed(seed);
+    next_frame_ = 0;
+  }
+  unsigned long long skipped_pixels =
+      pixels_per_frame_ * static_cast<unsigned long long>(frame - next_frame_);
+  intensity_engine_.discard(skipped_pixels * kIntensityDrawsPerPixel *
+                            kEngineCallsPerDraw);
+  coin_flip_engine_.discard(skipped_pixels * kCoinFlipsPerPixel *
+                            kEngineCallsPerDraw);
+  next_frame_ = frame + 1;
+}
+
+// The seed of the generator behind IndexedNoise.
+const unsigned long long kIndexedNoiseSeed = 0x0123456789ABCDEFULL;
+// IndexedNoise uses one byte of each 64-bit random value per pixel.
+const int kPixelsPerRandomValue = 8;
+// Palette indices are a three bit channel mask above a five bit level.
+const int kIndexedLevelBits = 5;
+const int kIndexedLevels = 1 << kIndexedLevelBits;
+
+namespace {
+
+// The counter'th value of a SplitMix64 stream started at seed.
+unsigned long long SplitMix64(unsigned long long seed,
+                              unsigned long long counter) {
+  unsigned long long z = seed + (counter + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+}  // namespace
+
+IndexedNoise::IndexedNoise(int image_width, int image_height)
+    : pixels_per_frame_{static_cast<unsigned long long>(image_width) *
+                        image_height} {}
+
+std::vector<unsigned char> IndexedNoise::ColorTable() {
+  std::vector<unsigned char> color_table;
+  for (int index = 0; index < 256; index++) {
+    int mask = index >> kIndexedLevelBits;
+    int level = index & (kIndexedLevels - 1);
+    // The middle of the level's share of the 0 to 1 intensity range.
+    unsigned char intensity =
+        (unsigned char)((255 * (2 * level + 1) + kIndexedLevels) /
+                        (2 * kIndexedLevels));
+    color_table.push_back(mask & 1 ? intensity : 0);
+    color_table.push_back(mask & 2 ? intensity : 0);
+    color_table.push_back(mask & 4 ? intensity : 0);
+  }
+  color_table.at(3 * kIndexedTextIndex) = 255;
+  color_table.at(3 * kIndexedTextIndex + 1) = 255;
+  color_table.at(3 * kIndexedTextIndex + 2) = 0;
+  return color_table;
+}
+
+void IndexedNoise::Render(int frame, unsigned char* indices) const {
+  unsigned long long values_per_frame =
+      (pixels_per_frame_ + kPixelsPerRandomValue - 1) / kPixelsPerRandomValue;
+  unsigned long long counter =
+      values_per_frame * static_cast<unsigned long long>(frame);
+  unsigned long long random_value{0};
+  for (unsigned long long pixel = 0; pixel < pixels_per_frame_; pixel++) {
+    if (pixel % kPixelsPerRandomValue == 0) {
+      random_value = SplitMix64(kIndexedNoiseSeed, counter++);
+    }
+    unsigned char index = random_value & 0xFF;
+    random_value >>= 8;
+    // With no channel lit every level is black.
+    indices[pixel] = index < kIndexedLevels ? 0 : index;
+  }
+}
+
+// The seeds of the tiles of TiledNoise and of its frame layouts.
+const unsigned long long kTileNoiseSeed = 0x00C0FFEE00C0FFEEULL;
+const unsigned long long kTileLayoutSeed = 0x5EED5EED5EED5EEDULL;
+// The tile size at kMinTileRandomness.
+const int kLargestTileSize = 128;
+// Each tile is stored in this many rotations of a quarter turn.
+const int kTileRotations = 4;
+
+TiledNoise::TiledNoise(int image_width, int image_height, int randomness)
+    : image_width_{image_width},
+      image_height_{image_height},
+      tile_size_{kLargestTileSize >> (randomness - kMinTileRandomness)} {
+  std::size_t tile_bytes = std::size_t(tile_size_) * tile_size_ * 3;
+  atlas_.resize(tile_bytes * kTileCount * kTileRotations);
+  unsigned long long counter{0};
+  for (int tile = 0; tile < kTileCount; tile++) {
+    // Draw the upright tile the way the shaded noise draws pixels: a random
+    // intensity in the channels picked by three coin flips.
+    unsigned char* upright = atlas_.data() + tile * kTileRotations * tile_bytes;
+    for (std::size_t pixel = 0; pixel < tile_bytes / 3; pixel++) {
+      unsigned long long random_value = SplitMix64(kTileNoiseSeed, counter++);
+      unsigned char intensity = random_value & 0xFF;
+      int mask = int(random_value >> 8) & 7;
+      for (int channel = 0; channel < 3; channel++) {
+        upright[3 * pixel + channel] = mask & (1 << channel) ? intensity : 0;
+      }
+    }
+    // Each rotation turns the one before it a quarter turn clockwise.
+    for (int rotation = 1; rotation < kTileRotations; rotation++) {
+      int variant = tile * kTileRotations + rotation;
+      unsigned char* rotated = atlas_.data() + variant * tile_bytes;
+      for (int row = 0; row < tile_size_; row++) {
+        for (int column = 0; column < tile_size_; column++) {
+          const unsigned char* source =
+              TileRow(variant - 1, tile_size_ - 1 - column) + 3 * row;
+          unsigned char* destination =
+              rotated + (std::size_t(row) * tile_size_ + column) * 3;
+          destination[0] = source[0];
+          destination[1] = source[1];
+          destination[2] = source[2];
+        }
+      }
+    }
+  }
+}
+
+void TiledNoise::Render(int frame, FrameBuffer* image) const {
+  // Shifting the grid can add a partly covered cell at each end of a row.
+  int cell_columns = image_width_ / tile_size_ + 2;
+  unsigned long long layout_seed =
+      SplitMix64(kTileLayoutSeed, static_cast<unsigned long long>(frame));
+  unsigned long long offsets = SplitMix64(layout_seed, 0);
+  int offset_x = int(offsets % tile_size_);
+  int offset_y = int((offsets >> 32) % tile_size_);
+  std::vector<int> cell_variants(cell_columns);
+  int cell_row = -1;
+  for (int row = 0; row < image_height_; row++) {
+    int grid_row = row + offset_y;
+    if (grid_row / tile_size_ != cell_row) {
+      cell_row = grid_row / tile_size_;
+      for (int cell = 0; cell < cell_columns; cell++) {
+        unsigned long long choice = SplitMix64(
+            layout_seed, 1 + std::size_t(cell_row) * cell_columns + cell);
+        cell_variants[cell] = int(choice % (kTileCount * kTileRotations));
+      }
+    }
+    int tile_row = grid_row % tile_size_;
+    unsigned char* output = image->row(row);
+    // The first cell is cut short by the offset; the last by the edge.
+    int column = 0;
+    int tile_column = offset_x;
+    int cell = 0;
+    while (column < image_width_) {
+      int run = std::min(tile_size_ - tile_column, image_width_ - column);
+      std::memcpy(output + 3 * std::size_t(column),
+                  TileRow(cell_variants[cell], tile_row) + 3 * tile_column,
+                  3 * std::size_t(run));
+      column += run;
+      tile_column = 0;
+      cell++;
+    }
+  }
+}
+
+namespace {
+
+// Draw message across the middle of image in color.
+void DrawMessage(const std::string& message, const Magick::Color& color,
+                 Magick::Image* image) {
+  image->font("Helvetica");
+  image->fontPointsize(image->rows() / 3.0);
+  image->fillColor(color);
+  image->annotate(message, Magick::CenterGravity);
+}
+
+}  // namespace
+
+std::vector<unsigned char> MessageCoverage(const std::string& message,
+                                           int image_width, int image_height) {
+  if (message.empty()) {
+    // Nothing to draw, so skip GraphicsMagick; the noise is left as it is.
+    return std::vector<unsigned char>(std::size_t(image_width) * image_height);
+  }
+  Magick::Image mask(Magick::Geometry(image_width, image_height),
+                     Magick::Color("black"));
+  DrawMessage(message, Magick::Color("white"), &mask);
+  std::vector<unsigned char> coverage(std::size_t(image_width) *
+                                      image_height);
+  mask.write(0, 0, image_width, image_height, "I", Magick::CharPixel,
+             coverage.data());
+  return coverage;
+}
+
+void BlendMessage(const std::vector<unsigned char>& coverage,
+                  FrameBuffer* image) {
+  const unsigned char kYellow[3]{255, 255, 0};
+  unsigned char* pixels = image->data();
+  for (std::size_t pixel = 0; pixel < coverage.size(); pixel++) {
+    unsigned int alpha = coverage[pixel];
+    if (alpha == 0) {
+      continue;
+    }
+    for (int channel = 0; channel < 3; channel++) {
+      unsigned char& value = pixels[3 * pixel + channel];
+      value = (unsigned char)((kYellow[channel] * alpha +
+                               value * (255 - alpha) + 127) /
+                              255);
+    }
+  }
+}
+
+void OverlayIndexedMessage(const std::vector<unsigned char>& coverage,
+                           unsigned char* indices) {
+  for (std::size_t pixel = 0; pixel < coverage.size(); pixel++) {
+    if (coverage[pixel] >= 128) {
+      indices[pixel] = kIndexedTextIndex;
+    }
+  }
+}
+
+PixelFormat MessagePixelFormat(const MessageParams& params) {
+  return params.noise == MessageNoise::kIndexed ? PixelFormat::kIndexed8
+                                                : PixelFormat::kRgb8;
+}
+
+void RenderMessage(const MessageParams& params, int thread_count,
+                   bool report_progress, FramePool* frame_pool,
+                   FrameSink* sink) {
+  int image_width = params.image_width;
+  int image_height = params.image_height;
+  AnimationSpec spec{image_width, image_height, params.number_of_images,
+                     thread_count, report_progress, params.first_frame,
+                     params.end_frame, params.profiler};
+  ProfileScope setup(params.profiler, "setup");
+  // The message is the same on every frame, so it is drawn only once.
+  std::vector<unsigned char> coverage =
+      MessageCoverage(params.message, image_width, image_height);
+  if (params.noise == MessageNoise::kIndexed) {
+    IndexedNoise indexed_noise(image_width, image_height);
+    setup.Stop();
+    RenderIndexedAnimation(
+        spec, IndexedNoise::ColorTable(),
+        [&indexed_noise, &coverage](int frame, unsigned char* indices) {
+          indexed_noise.Render(frame, indices);
+          OverlayIndexedMessage(coverage, indices);
+        },
+        frame_pool, sink);
+  } else if (params.noise == MessageNoise::kTiles) {
+    TiledNoise tiled_noise(image_width, image_height, params.tile_randomness);
+    setup.Stop();
+    FillAnimation(
+        spec,
+        [&tiled_noise](int frame, FrameBuffer* image) {
+          tiled_noise.Render(frame, image);
+        },
+        [&coverage](FrameBuffer* image) { BlendMessage(coverage, image); },
+        frame_pool, sink);
+  } else {
+    NoiseShader shader(image_width, image_height);
+    setup.Stop();
+    RenderAnimation(
+        spec, shader,
+        [&coverage](FrameBuffer* image) { BlendMessage(coverage, image); },
+        frame_pool, sink);
+  }
+}
+
+FrameBuffer RenderFrame(const MessageParams& params, int frame) {
+  if (frame < 0 || frame >= params.number_of_images) {
+    throw std::out_of_range("The frame to render is out of range.");
+  }
+  int image_width = params.image_width;
+  int image_height = params.image_height;
+  std::vector<unsigned char> coverage =
+      MessageCoverage(params.message, image_width, image_height);
+  FrameBuffer image(image_width, image_height, PixelFormat::kRgb8);
+  if (params.noise == MessageNoise::kIndexed) {
+    FrameBuffer indices(image_width, image_height, PixelFormat::kIndexed8);
+    IndexedNoise(image_width, image_height).Render(frame, indices.data());
+    OverlayIndexedMessage(coverage, indices.data());
+    // Look every index up in the palette, as a GIF viewer would.
+    std::vector<unsigned char> color_table = IndexedNoise::ColorTable();
+    unsigned char* rgb = image.data();
+    for (std::size_t pixel = 0; pixel < indices.size_bytes(); pixel++) {
+      const unsigned char* color =
+          color_table.data() + 3 * std::size_t(indices.data()[pixel]);
+      *rgb++ = color[0];
+      *rgb++ = color[1];
+      *rgb++ = color[2];
+    }
+    return image;
+  }
+  if (params.noise == MessageNoise::kTiles) {
+    TiledNoise(image_width, image_height, params.tile_randomness)
+        .Render(frame, &image);
+  } else {
+    NoiseShader shader(image_width, image_height);
+    ShadeFrame(shader, frame, 1, &image);
+  }
+  BlendMessage(coverage, &image);
+  return image;
+}
+
+QualityPlan PlanMessageForDeadline(int deadline_ms, bool encodes_gif,
+                                   int thread_count, MessageParams* params) {
+  MessageParams probe_params{*params};
+  probe_params.first_frame = 0;
+  probe_params.end_frame =
+      std::min(kProbeFrameCount, params->number_of_images);
+  probe_params.profiler = nullptr;
+  QualityPlan plan = PlanForDeadline(
+      params->image_width, params->image_height, params->number_of_images,
+      MessagePixelFormat(*params), encodes_gif, deadline_ms,
+      [&probe_params, thread_count](FramePool* probe_pool, FrameSink* probe) {
+        RenderMessage(probe_params, thread_count, false, probe_pool, probe);
+      });
+  params->image_width = plan.width;
+  params->image_height = plan.height;
+  params->number_of_images = plan.frame_count;
+  params->first_frame = 0;
+  params->end_frame = -1;
+  return plan;
+}
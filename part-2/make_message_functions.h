@@ -16,9 +16,20 @@
 #ifndef MAKE_MESSAGE_FUNCTIONS_H
 #define MAKE_MESSAGE_FUNCTIONS_H
 
+#include <Magick++.h>
+
+#include <cstddef>
 #include <iostream>
 #include <random>
 #include <string>
+#include <vector>
+
+#include "frame_buffer.h"
+#include "frame_pool.h"
+#include "frame_shader.h"
+#include "frame_sink.h"
+#include "perf_counters.h"
+#include "quality_planner.h"
 
 // Check to see if file_name ends with the string extension, returns true if
 // file_name ends with extension, false otherwise.
@@ -110,4 +121,202 @@ class RandomNumberGenerator {
   }
 };
 
+/// Shades random noise. Every pixel gets one random intensity and a coin flip
+/// for each of red, green and blue decides which channels receive it.
+///
+/// The shader draws from its own copies of the seeded streams behind
+/// RandomDouble01() and CoinFlip(), so its noise is the same as drawing
+/// from those functions one pixel after another. Because every frame uses a
+/// known number of draws, BeginFrame() can move the streams directly to the
+/// start of any frame; frames do not have to be rendered in order.
+class NoiseShader {
+ public:
+  static constexpr bool kIndependentPixels = false;
+
+  /// Prepare noise for frames that are \p image_width by \p image_height
+  /// pixels.
+  NoiseShader(int image_width, int image_height);
+
+  /// Move the random streams to the start of frame \p frame.
+  void BeginFrame(int frame);
+
+  PixelColor operator()(int column, int row, int frame) {
+    double random_color_intensity = intensity_dist_(intensity_engine_);
+    PixelColor color{0.0, 0.0, 0.0};
+    if (coin_flip_dist_(coin_flip_engine_) > 0.0) {
+      color.red = random_color_intensity;
+    }
+    if (coin_flip_dist_(coin_flip_engine_) > 0.0) {
+      color.green = random_color_intensity;
+    }
+    if (coin_flip_dist_(coin_flip_engine_) > 0.0) {
+      color.blue = random_color_intensity;
+    }
+    return color;
+  }
+
+ private:
+  unsigned long long pixels_per_frame_;
+  // The frame the streams are positioned at the start of.
+  int next_frame_;
+  std::mt19937 intensity_engine_;
+  std::mt19937 coin_flip_engine_;
+  std::uniform_real_distribution<double> intensity_dist_;
+  std::uniform_real_distribution<double> coin_flip_dist_;
+};
+
+/// The palette index that IndexedNoise leaves free for the message.
+const unsigned char kIndexedTextIndex = 1;
+
+/// Draws the same kind of noise as NoiseShader, but straight from a fixed
+/// palette of 8 channel masks times 32 intensity levels. Frames come out as
+/// palette indices, so they can be written as GIF frames without being
+/// quantized.
+///
+/// Each pixel takes one random byte: the top three bits pick which of red,
+/// green and blue are lit, like the three coin flips, and the low five bits
+/// pick the intensity. The bytes come from a counter based generator keyed by
+/// frame and position, so any frame can be rendered on its own. The noise is
+/// not the same as NoiseShader's, only alike in distribution.
+class IndexedNoise {
+ public:
+  /// Prepare noise for frames that are \p image_width by \p image_height
+  /// pixels.
+  IndexedNoise(int image_width, int image_height);
+
+  /// The 256 color palette the indices refer to, as RGB triples. Every
+  /// unlit index is drawn as index 0, which leaves indices 1 to 31 free;
+  /// kIndexedTextIndex is yellow.
+  static std::vector<unsigned char> ColorTable();
+
+  /// Fill \p indices with the palette indices of frame \p frame, row by row.
+  void Render(int frame, unsigned char* indices) const;
+
+ private:
+  unsigned long long pixels_per_frame_;
+};
+
+/// The range of the randomness knob of TiledNoise.
+const int kMinTileRandomness = 1;
+const int kMaxTileRandomness = 6;
+
+/// Assembles noise frames from a small atlas of noise tiles that is made
+/// once, instead of drawing new random numbers for every pixel.
+///
+/// The atlas holds kTileCount tiles, each in all four rotations. Every frame
+/// lays the tiles out on a grid that is shifted by a random offset, picking
+/// a random tile and rotation for every cell, and copies them in with one
+/// memcpy per tile row. The choices come from a counter based generator
+/// keyed by frame, so any frame can be assembled on its own.
+///
+/// \p randomness trades randomness for speed: every step up halves the
+/// tile size, from 128 pixels at kMinTileRandomness down to 4 at
+/// kMaxTileRandomness, giving four times as many independent choices per
+/// frame but four times as many, shorter, copies.
+class TiledNoise {
+ public:
+  /// The number of distinct tiles in the atlas.
+  static const int kTileCount = 16;
+
+  /// Prepare tiles for frames that are \p image_width by \p image_height
+  /// pixels.
+  TiledNoise(int image_width, int image_height, int randomness);
+
+  /// The width and height of every tile.
+  int tile_size() const { return tile_size_; }
+
+  /// Fill every pixel of the RGB8 \p image with frame \p frame.
+  void Render(int frame, FrameBuffer* image) const;
+
+ private:
+  // The start of row row of the rotated tile variant.
+  const unsigned char* TileRow(int variant, int row) const {
+    return atlas_.data() +
+           (std::size_t(variant) * tile_size_ + row) * tile_size_ * 3;
+  }
+
+  int image_width_;
+  int image_height_;
+  int tile_size_;
+  // kTileCount tiles in each of 4 rotations, each tile_size_ rows of RGB8.
+  std::vector<unsigned char> atlas_;
+};
+
+/// The ways the noise behind the message can be made.
+enum class MessageNoise {
+  /// NoiseShader: a fresh random intensity and coin flips for every pixel.
+  kShaded,
+  /// IndexedNoise: palette indices that need no GIF quantization.
+  kIndexed,
+  /// TiledNoise: frames assembled from a small atlas of noise tiles.
+  kTiles
+};
+
+/// The size, length, text and noise of a message animation.
+struct MessageParams {
+  int image_width;
+  int image_height;
+  int number_of_images;
+  std::string message;
+  MessageNoise noise = MessageNoise::kShaded;
+  /// The randomness of kTiles noise, from kMinTileRandomness to
+  /// kMaxTileRandomness.
+  int tile_randomness = 3;
+  /// Render only frames first_frame up to but not including end_frame; an
+  /// end_frame of -1 stands for number_of_images. Every frame has the same
+  /// noise as in a full run.
+  int first_frame = 0;
+  int end_frame = -1;
+  /// Measures drawing the message and preparing the noise, as the "setup"
+  /// phase, and rendering each frame when not null.
+  FrameProfiler* profiler = nullptr;
+};
+
+/// The format of the frames of the animation described by \p params.
+PixelFormat MessagePixelFormat(const MessageParams& params);
+
+/// Render every frame of the message animation described by \p params and
+/// hand them to \p sink. Frames come from \p frame_pool, which must hold
+/// frames of the animation's size in MessagePixelFormat(). Shaded noise is
+/// always rendered on one thread; \p thread_count is kept for symmetry with
+/// RenderGradient(). Progress is reported on standard error if
+/// \p report_progress is set.
+void RenderMessage(const MessageParams& params, int thread_count,
+                   bool report_progress, FramePool* frame_pool,
+                   FrameSink* sink);
+
+/// Draw \p message in Helvetica across the middle of an \p image_width by
+/// \p image_height frame and return how much of each pixel it covers, from 0
+/// to 255, row by row. The text is drawn once, with GraphicsMagick; the
+/// coverage can then be laid over every frame. An empty message covers
+/// nothing and does not need GraphicsMagick.
+std::vector<unsigned char> MessageCoverage(const std::string& message,
+                                           int image_width, int image_height);
+
+/// Blend yellow into the RGB8 \p image as much as the message in
+/// \p coverage covers each pixel.
+void BlendMessage(const std::vector<unsigned char>& coverage,
+                  FrameBuffer* image);
+
+/// Set every pixel of \p indices that is mostly covered by the message in
+/// \p coverage to kIndexedTextIndex.
+void OverlayIndexedMessage(const std::vector<unsigned char>& coverage,
+                           unsigned char* indices);
+
+/// Render only frame number \p frame of the message animation described by
+/// \p params as RGB8, with the noise of \p params. The noise matches the
+/// same frame of a full run; indexed noise is looked up in its palette.
+/// Throws std::out_of_range if \p frame is not one of the animation's
+/// frames.
+FrameBuffer RenderFrame(const MessageParams& params, int frame);
+
+/// Time one frame of the message animation described by \p params, rendered
+/// with \p thread_count threads, and lower the size, length and GIF
+/// quantization effort in \p params until the whole animation fits in
+/// \p deadline_ms milliseconds. \p encodes_gif tells whether the output is
+/// a GIF. Every frame of the planned animation is rendered, whatever range
+/// \p params asked for before. Returns the plan that was applied.
+QualityPlan PlanMessageForDeadline(int deadline_ms, bool encodes_gif,
+                                   int thread_count, MessageParams* params);
+
 #endif
\ No newline at end of file
@@ -16,9 +16,15 @@
 #include <gtest/gtest.h>
 #include <limits.h>
 
+#include <algorithm>
 #include <cstdio>
+#include <fstream>
 #include <future>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
+#include "frame_digest.h"
 #include "make_message_functions.h"
 
 // Thanks to Paul Inventado
@@ -128,4 +134,216 @@ TEST(CoinFlip, PredictableSeries) {
   }
 }
 
+TEST(NoiseShader, MatchesRandomFunctions) {
+  std::seed_seq seed{1, 2, 3, 4, 5};
+  RandomNumberGenerator intensity{0, 1, seed};
+  RandomNumberGenerator coin_flip{-1, 1, seed};
+  NoiseShader shader(4, 3);
+  for (int frame = 0; frame < 2; frame++) {
+    shader.BeginFrame(frame);
+    for (int row = 0; row < 3; row++) {
+      for (int column = 0; column < 4; column++) {
+        double random_color_intensity = intensity.next();
+        double red = coin_flip.next() > 0.0 ? random_color_intensity : 0.0;
+        double green = coin_flip.next() > 0.0 ? random_color_intensity : 0.0;
+        double blue = coin_flip.next() > 0.0 ? random_color_intensity : 0.0;
+        PixelColor color = shader(column, row, frame);
+        EXPECT_DOUBLE_EQ(red, color.red);
+        EXPECT_DOUBLE_EQ(green, color.green);
+        EXPECT_DOUBLE_EQ(blue, color.blue);
+      }
+    }
+  }
+}
+
+TEST(NoiseShader, SeeksToAnyFrame) {
+  NoiseShader in_order(5, 2);
+  std::vector<double> frame_three;
+  for (int frame = 0; frame < 4; frame++) {
+    in_order.BeginFrame(frame);
+    for (int pixel = 0; pixel < 10; pixel++) {
+      PixelColor color = in_order(pixel % 5, pixel / 5, frame);
+      if (frame == 3) {
+        frame_three.push_back(color.red + 2 * color.green + 4 * color.blue);
+      }
+    }
+  }
+  NoiseShader seeking(5, 2);
+  // Render a later frame first, then jump backwards to frame three.
+  seeking.BeginFrame(6);
+  seeking(0, 0, 6);
+  seeking.BeginFrame(3);
+  for (int pixel = 0; pixel < 10; pixel++) {
+    PixelColor color = seeking(pixel % 5, pixel / 5, 3);
+    EXPECT_DOUBLE_EQ(frame_three.at(pixel),
+                     color.red + 2 * color.green + 4 * color.blue);
+  }
+}
+
+TEST(BlendMessage, BlendsYellowByCoverage) {
+  FrameBuffer image(3, 1, PixelFormat::kRgb8);
+  std::fill(image.data(), image.data() + image.size_bytes(), 100);
+  BlendMessage({0, 255, 51}, &image);
+  std::vector<unsigned char> expected{100, 100, 100, 255, 255, 0, 131, 131, 80};
+  EXPECT_EQ(expected,
+            std::vector<unsigned char>(image.data(),
+                                       image.data() + image.size_bytes()));
+}
+
+TEST(TiledNoise, CopiesRotatedTiles) {
+  for (int randomness = kMinTileRandomness; randomness <= kMaxTileRandomness;
+       randomness++) {
+    TiledNoise noise(100, 30, randomness);
+    EXPECT_EQ(128 >> (randomness - 1), noise.tile_size());
+    FrameBuffer first(100, 30, PixelFormat::kRgb8);
+    FrameBuffer again(100, 30, PixelFormat::kRgb8);
+    FrameBuffer second(100, 30, PixelFormat::kRgb8);
+    noise.Render(4, &first);
+    TiledNoise(100, 30, randomness).Render(4, &again);
+    noise.Render(5, &second);
+    std::vector<unsigned char> first_bytes(first.data(),
+                                           first.data() + first.size_bytes());
+    EXPECT_EQ(first_bytes,
+              std::vector<unsigned char>(again.data(),
+                                         again.data() + again.size_bytes()));
+    EXPECT_NE(first_bytes,
+              std::vector<unsigned char>(second.data(),
+                                         second.data() + second.size_bytes()));
+    // Every pixel is an intensity in some of the channels.
+    for (std::size_t pixel = 0; pixel < 100 * 30; pixel++) {
+      unsigned char intensity = 0;
+      for (int channel = 0; channel < 3; channel++) {
+        unsigned char value = first_bytes.at(3 * pixel + channel);
+        if (value != 0) {
+          if (intensity != 0) {
+            EXPECT_EQ(intensity, value);
+          }
+          intensity = value;
+        }
+      }
+    }
+  }
+}
+
+TEST(IndexedNoise, SeeksToAnyFrame) {
+  IndexedNoise noise(7, 5);
+  std::vector<unsigned char> frame_two(35);
+  std::vector<unsigned char> frame_three(35);
+  noise.Render(2, frame_two.data());
+  noise.Render(3, frame_three.data());
+  EXPECT_NE(frame_two, frame_three);
+  std::vector<unsigned char> again(35);
+  IndexedNoise(7, 5).Render(3, again.data());
+  EXPECT_EQ(frame_three, again);
+}
+
+TEST(IndexedNoise, LightsEachChannelHalfTheTime) {
+  const int width = 200;
+  const int height = 100;
+  IndexedNoise noise(width, height);
+  std::vector<unsigned char> indices(width * height);
+  noise.Render(0, indices.data());
+  std::vector<unsigned char> color_table = IndexedNoise::ColorTable();
+  ASSERT_EQ(256 * 3, color_table.size());
+  int lit[3]{0, 0, 0};
+  for (unsigned char index : indices) {
+    ASSERT_NE(kIndexedTextIndex, index);
+    for (int channel = 0; channel < 3; channel++) {
+      if (color_table.at(3 * index + channel) > 0) {
+        lit[channel]++;
+      }
+    }
+  }
+  for (int channel = 0; channel < 3; channel++) {
+    EXPECT_NEAR(0.5, double(lit[channel]) / indices.size(), 0.02);
+  }
+}
+
+// The digests of the default animation with noise \p noise and no message,
+// which can be rendered without GraphicsMagick.
+std::string BlankMessageDigests(MessageNoise noise) {
+  MessageParams params{1024, 576, 5, ""};
+  params.noise = noise;
+  FramePool frame_pool(1024, 576, MessagePixelFormat(params));
+  std::ostringstream digests;
+  DigestSink sink(digests, 0, &frame_pool);
+  RenderMessage(params, 1, false, &frame_pool, &sink);
+  return digests.str();
+}
+
+std::string ReadGoldenDigests(const std::string& file_name) {
+  std::ifstream golden_file(file_name);
+  std::ostringstream golden;
+  golden << golden_file.rdbuf();
+  return golden.str();
+}
+
+TEST(RenderMessage, MatchesGoldenDigests) {
+  EXPECT_EQ(ReadGoldenDigests("sample_images/blank_message.digest"),
+            BlankMessageDigests(MessageNoise::kShaded));
+  EXPECT_EQ(ReadGoldenDigests("sample_images/blank_message_indexed.digest"),
+            BlankMessageDigests(MessageNoise::kIndexed));
+}
+
+// The digest line DigestSink writes for each frame of a full run of
+// \p params.
+std::vector<std::string> FullRunDigests(const MessageParams& params) {
+  FramePool frame_pool(params.image_width, params.image_height,
+                       MessagePixelFormat(params));
+  std::ostringstream digests;
+  DigestSink sink(digests, 0, &frame_pool);
+  RenderMessage(params, 1, false, &frame_pool, &sink);
+  std::istringstream lines(digests.str());
+  std::vector<std::string> frame_digests;
+  std::string line;
+  while (std::getline(lines, line) && line.rfind("frame ", 0) == 0) {
+    frame_digests.push_back(line);
+  }
+  return frame_digests;
+}
+
+TEST(RenderFrame, MatchesFullRunForEveryNoise) {
+  for (MessageNoise noise :
+       {MessageNoise::kShaded, MessageNoise::kIndexed, MessageNoise::kTiles}) {
+    MessageParams params{48, 20, 4, ""};
+    params.noise = noise;
+    std::vector<std::string> digests = FullRunDigests(params);
+    ASSERT_EQ(4, digests.size());
+    for (int frame : {3, 0, 2}) {
+      FrameBuffer image = RenderFrame(params, frame);
+      EXPECT_EQ(PixelFormat::kRgb8, image.format());
+      EXPECT_EQ("frame " + std::to_string(frame) + " " +
+                    DigestText(DigestBytes(image.data(), image.size_bytes())),
+                digests.at(frame));
+    }
+  }
+}
+
+TEST(RenderFrame, RejectsFramesOutOfRange) {
+  for (MessageNoise noise :
+       {MessageNoise::kShaded, MessageNoise::kIndexed, MessageNoise::kTiles}) {
+    MessageParams params{48, 20, 4, ""};
+    params.noise = noise;
+    EXPECT_THROW(RenderFrame(params, -1), std::out_of_range);
+    EXPECT_THROW(RenderFrame(params, 4), std::out_of_range);
+  }
+}
+
+TEST(PlanMessageForDeadline, RendersEveryPlannedFrame) {
+  for (int deadline_ms : {1, 1000000}) {
+    MessageParams params{96, 64, 5, ""};
+    // The whole animation, as the program asks for it without --frames.
+    params.end_frame = 5;
+    QualityPlan plan = PlanMessageForDeadline(deadline_ms, false, 1, &params);
+    EXPECT_EQ(plan.frame_count, params.number_of_images);
+    EXPECT_EQ(plan.width, params.image_width);
+    std::vector<std::string> digests = FullRunDigests(params);
+    EXPECT_EQ(plan.frame_count, digests.size()) << deadline_ms;
+  }
+  MessageParams params{96, 64, 5, ""};
+  QualityPlan plan = PlanMessageForDeadline(1000000, false, 1, &params);
+  EXPECT_EQ(5, plan.frame_count);
+  EXPECT_TRUE(plan.degradations.empty());
+}
+
 }  // namespace